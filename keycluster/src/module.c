@@ -1,6 +1,7 @@
 #include "fsl_gpio.h"
 #include "fsl_port.h"
 #include "module.h"
+#include "module/key_scanner.h"
 
 #define BLACKBERRY_TRACKBALL_LEFT_PORT PORTA
 #define BLACKBERRY_TRACKBALL_LEFT_GPIO GPIOA
@@ -26,7 +27,14 @@
 #define BLACKBERRY_TRACKBALL_DOWN_CLOCK kCLOCK_PortA
 #define BLACKBERRY_TRACKBALL_DOWN_PIN 12
 
-pointer_delta_t PointerDelta;
+#define BLACKBERRY_TRACKBALL_DIRECTION_COUNT 4
+
+// Edges of the same hall sensor closer to each other than this are considered bounces.
+#define BLACKBERRY_TRACKBALL_DEBOUNCE_USEC 50
+#define BLACKBERRY_TRACKBALL_DEBOUNCE_TICKS (BLACKBERRY_TRACKBALL_DEBOUNCE_USEC * (SystemCoreClock / 1000000))
+#define SYSTICK_MAX_VALUE 0x00ffffff
+
+pointer_seqlock_t PointerDelta;
 
 key_vector_t KeyVector = {
     .itemNum = KEYBOARD_VECTOR_ITEMS_NUM,
@@ -41,23 +49,121 @@ key_vector_t KeyVector = {
     .keyStates = {0}
 };
 
+typedef struct {
+    PORT_Type *port;
+    GPIO_Type *gpio;
+    IRQn_Type irq;
+    clock_ip_name_t clock;
+    uint32_t pin;
+    bool isHorizontal;
+    int8_t step;
+    uint8_t level;
+    uint32_t lastEdgeTime;
+} blackberry_trackball_direction_t;
+
+static blackberry_trackball_direction_t directions[BLACKBERRY_TRACKBALL_DIRECTION_COUNT] = {
+    {
+        .port = BLACKBERRY_TRACKBALL_LEFT_PORT,
+        .gpio = BLACKBERRY_TRACKBALL_LEFT_GPIO,
+        .irq = BLACKBERRY_TRACKBALL_LEFT_IRQ,
+        .clock = BLACKBERRY_TRACKBALL_LEFT_CLOCK,
+        .pin = BLACKBERRY_TRACKBALL_LEFT_PIN,
+        .isHorizontal = true,
+        .step = -1,
+    },
+    {
+        .port = BLACKBERRY_TRACKBALL_RIGHT_PORT,
+        .gpio = BLACKBERRY_TRACKBALL_RIGHT_GPIO,
+        .irq = BLACKBERRY_TRACKBALL_RIGHT_IRQ,
+        .clock = BLACKBERRY_TRACKBALL_RIGHT_CLOCK,
+        .pin = BLACKBERRY_TRACKBALL_RIGHT_PIN,
+        .isHorizontal = true,
+        .step = 1,
+    },
+    {
+        .port = BLACKBERRY_TRACKBALL_UP_PORT,
+        .gpio = BLACKBERRY_TRACKBALL_UP_GPIO,
+        .irq = BLACKBERRY_TRACKBALL_UP_IRQ,
+        .clock = BLACKBERRY_TRACKBALL_UP_CLOCK,
+        .pin = BLACKBERRY_TRACKBALL_UP_PIN,
+        .isHorizontal = false,
+        .step = -1,
+    },
+    {
+        .port = BLACKBERRY_TRACKBALL_DOWN_PORT,
+        .gpio = BLACKBERRY_TRACKBALL_DOWN_GPIO,
+        .irq = BLACKBERRY_TRACKBALL_DOWN_IRQ,
+        .clock = BLACKBERRY_TRACKBALL_DOWN_CLOCK,
+        .pin = BLACKBERRY_TRACKBALL_DOWN_PIN,
+        .isHorizontal = false,
+        .step = 1,
+    },
+};
+
 void BlackberryTrackball_Init(void)
 {
-    CLOCK_EnableClock(BLACKBERRY_TRACKBALL_LEFT_CLOCK);
-    PORT_SetPinConfig(BLACKBERRY_TRACKBALL_LEFT_PORT, BLACKBERRY_TRACKBALL_LEFT_PIN,
-        &(port_pin_config_t){.pullSelect=kPORT_PullUp, .mux=kPORT_MuxAsGpio});
+    // SysTick is used as a free running timestamp for debouncing, without its interrupt.
+    SysTick->LOAD = SYSTICK_MAX_VALUE;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    for (uint8_t i = 0; i < BLACKBERRY_TRACKBALL_DIRECTION_COUNT; i++) {
+        blackberry_trackball_direction_t *direction = &directions[i];
+        CLOCK_EnableClock(direction->clock);
+        PORT_SetPinConfig(direction->port, direction->pin,
+            &(port_pin_config_t){.pullSelect=kPORT_PullUp, .mux=kPORT_MuxAsGpio});
+        direction->level = GPIO_ReadPinInput(direction->gpio, direction->pin);
+        direction->lastEdgeTime = SysTick->VAL;
+        PORT_SetPinInterruptConfig(direction->port, direction->pin, kPORT_InterruptEitherEdge);
+        EnableIRQ(direction->irq);
+    }
+}
 
-    CLOCK_EnableClock(BLACKBERRY_TRACKBALL_RIGHT_CLOCK);
-    PORT_SetPinConfig(BLACKBERRY_TRACKBALL_RIGHT_PORT, BLACKBERRY_TRACKBALL_RIGHT_PIN,
-        &(port_pin_config_t){.pullSelect=kPORT_PullUp, .mux=kPORT_MuxAsGpio});
+// Every edge of a hall sensor moves the pointer by one step. The level check rejects
+// spurious interrupts whose level didn't actually change, the time check rejects bounces.
+// The level is tracked across bounces too, so that the next real edge still passes the check.
+static void blackberryTrackballHandleEdges(GPIO_Type *gpio)
+{
+    uint32_t interruptFlags = GPIO_GetPinsInterruptFlags(gpio);
+    uint32_t currentTime = SysTick->VAL;
+
+    for (uint8_t i = 0; i < BLACKBERRY_TRACKBALL_DIRECTION_COUNT; i++) {
+        blackberry_trackball_direction_t *direction = &directions[i];
+        if (direction->gpio != gpio || !(interruptFlags & (1U << direction->pin))) {
+            continue;
+        }
+
+        GPIO_ClearPinsInterruptFlags(gpio, 1U << direction->pin);
+
+        uint8_t level = GPIO_ReadPinInput(gpio, direction->pin);
+        // SysTick counts down.
+        uint32_t elapsedTicks = (direction->lastEdgeTime - currentTime) & SYSTICK_MAX_VALUE;
+        if (level == direction->level) {
+            continue;
+        }
+
+        direction->level = level;
+        if (elapsedTicks < BLACKBERRY_TRACKBALL_DEBOUNCE_TICKS) {
+            continue;
+        }
+
+        direction->lastEdgeTime = currentTime;
+        if (direction->isHorizontal) {
+            PointerSeqlock_Add(&PointerDelta, direction->step, 0, CurrentTime);
+        } else {
+            PointerSeqlock_Add(&PointerDelta, 0, direction->step, CurrentTime);
+        }
+    }
+}
 
-    CLOCK_EnableClock(BLACKBERRY_TRACKBALL_UP_CLOCK);
-    PORT_SetPinConfig(BLACKBERRY_TRACKBALL_UP_PORT, BLACKBERRY_TRACKBALL_UP_PIN,
-        &(port_pin_config_t){.pullSelect=kPORT_PullUp, .mux=kPORT_MuxAsGpio});
+void PORTA_IRQHandler(void)
+{
+    blackberryTrackballHandleEdges(GPIOA);
+}
 
-    CLOCK_EnableClock(BLACKBERRY_TRACKBALL_DOWN_CLOCK);
-    PORT_SetPinConfig(BLACKBERRY_TRACKBALL_DOWN_PORT, BLACKBERRY_TRACKBALL_DOWN_PIN,
-        &(port_pin_config_t){.pullSelect=kPORT_PullUp, .mux=kPORT_MuxAsGpio});
+void PORTB_IRQHandler(void)
+{
+    blackberryTrackballHandleEdges(GPIOB);
 }
 
 void InitLedDriverSdb(void)
@@ -68,41 +174,6 @@ void InitLedDriverSdb(void)
     GPIO_WritePinOutput(SDB_GPIO, SDB_PIN, 1);
 }
 
-void BlackberryTrackball_Update(void)
-{
-    static bool oldLeft, oldRight, oldUp, oldDown, firstRun=true;
-
-    uint8_t newLeft = GPIO_ReadPinInput(BLACKBERRY_TRACKBALL_LEFT_GPIO, BLACKBERRY_TRACKBALL_LEFT_PIN);
-    if (oldLeft != newLeft) {
-        PointerDelta.x--;
-        oldLeft = newLeft;
-    }
-
-    uint8_t newRight = GPIO_ReadPinInput(BLACKBERRY_TRACKBALL_RIGHT_GPIO, BLACKBERRY_TRACKBALL_RIGHT_PIN);
-    if (oldRight != newRight) {
-        PointerDelta.x++;
-        oldRight = newRight;
-    }
-
-    uint8_t newUp = GPIO_ReadPinInput(BLACKBERRY_TRACKBALL_UP_GPIO, BLACKBERRY_TRACKBALL_UP_PIN);
-    if (oldUp != newUp) {
-        PointerDelta.y--;
-        oldUp = newUp;
-    }
-
-    uint8_t newDown = GPIO_ReadPinInput(BLACKBERRY_TRACKBALL_DOWN_GPIO, BLACKBERRY_TRACKBALL_DOWN_PIN);
-    if (oldDown != newDown) {
-        PointerDelta.y++;
-        oldDown = newDown;
-    }
-
-    if (firstRun) {
-        PointerDelta.x = 0;
-        PointerDelta.y = 0;
-        firstRun = false;
-    }
-}
-
 void Module_Init(void)
 {
     KeyVector_Init(&KeyVector);
@@ -112,7 +183,6 @@ void Module_Init(void)
 
 void Module_Loop(void)
 {
-    BlackberryTrackball_Update();
 }
 
 void Module_ModuleSpecificCommand(module_specific_command_t command)
@@ -7,6 +7,7 @@
     #include "module/module_api.h"
     #include "key_vector.h"
     #include "slave_protocol.h"
+    #include "pointer_seqlock.h"
 
 // Macros:
 
@@ -34,7 +35,7 @@
 // Variables:
 
     extern key_vector_t KeyVector;
-    extern pointer_delta_t PointerDelta;
+    extern pointer_seqlock_t PointerDelta;
 
 // Functions:
 
@@ -1,6 +1,6 @@
 #include "module.h"
 
-pointer_delta_t PointerDelta;
+pointer_seqlock_t PointerDelta;
 
 key_matrix_t KeyMatrix = {
     .colNum = KEYBOARD_MATRIX_COLS_NUM,
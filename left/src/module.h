@@ -6,6 +6,7 @@
     #include "module/module_api.h"
     #include "key_matrix.h"
     #include "module/slave_protocol_handler.h"
+    #include "pointer_seqlock.h"
 
 // Macros:
 
@@ -39,7 +40,7 @@
 // Variables:
 
     extern key_matrix_t KeyMatrix;
-    extern pointer_delta_t PointerDelta;
+    extern pointer_seqlock_t PointerDelta;
 
 // Functions:
 
@@ -0,0 +1,62 @@
+#include <math.h>
+#include "acceleration_curve.h"
+
+#define MULTIPLIER_MAX ((float)INT32_MAX)
+#define MULTIPLIER_MIN ((float)INT32_MIN)
+
+// Samples the power curve once per point, so that per-sample evaluation is just a table lookup
+// and a linear interpolation in integer arithmetic.
+void AccelerationCurve_Build(acceleration_curve_t *curve, float baseSpeed, float speed, float xceleration, float midSpeed)
+{
+    for (uint8_t i = 0; i < ACCELERATION_CURVE_POINT_COUNT; i++) {
+        float pointSpeed = (float)(i << ACCELERATION_CURVE_STEP_BITS) / ACCELERATION_CURVE_SPEED_ONE;
+        float multiplier = baseSpeed + speed * powf(pointSpeed / midSpeed, xceleration);
+        float scaledMultiplier = multiplier * ACCELERATION_CURVE_MULTIPLIER_ONE;
+
+        if (scaledMultiplier >= MULTIPLIER_MAX) {
+            curve->points[i] = INT32_MAX;
+        } else if (scaledMultiplier <= MULTIPLIER_MIN) {
+            curve->points[i] = INT32_MIN;
+        } else {
+            curve->points[i] = (int32_t)scaledMultiplier;
+        }
+    }
+    curve->isValid = true;
+}
+
+int32_t AccelerationCurve_Evaluate(const acceleration_curve_t *curve, uint32_t speed)
+{
+    uint32_t segment = speed >> ACCELERATION_CURVE_STEP_BITS;
+    if (segment >= ACCELERATION_CURVE_SEGMENT_COUNT) {
+        segment = ACCELERATION_CURVE_SEGMENT_COUNT - 1;
+    }
+
+    // Past the last point, the offset exceeds the step and the last segment gets extrapolated.
+    int64_t offset = speed - (segment << ACCELERATION_CURVE_STEP_BITS);
+    int64_t start = curve->points[segment];
+    int64_t end = curve->points[segment + 1];
+    int64_t result = start + (((end - start) * offset) >> ACCELERATION_CURVE_STEP_BITS);
+
+    if (result > INT32_MAX) {
+        return INT32_MAX;
+    } else if (result < INT32_MIN) {
+        return INT32_MIN;
+    }
+    return result;
+}
+
+// Two segment alpha max plus beta min approximation of sqrt(x*x + y*y), within 1.5% of the exact
+// value. The error gets amplified by steep curves, hence the second segment. Arguments must fit
+// into 24 bits.
+uint32_t AccelerationCurve_Magnitude(int32_t x, int32_t y)
+{
+    uint32_t absX = x < 0 ? -x : x;
+    uint32_t absY = y < 0 ? -y : y;
+    uint32_t max = absX > absY ? absX : absY;
+    uint32_t min = absX > absY ? absY : absX;
+    uint32_t shallowMagnitude = (max * 127 + min * 25) >> 7;
+    uint32_t steepMagnitude = (max * 108 + min * 72) >> 7;
+    uint32_t magnitude = shallowMagnitude > steepMagnitude ? shallowMagnitude : steepMagnitude;
+
+    return magnitude > max ? magnitude : max;
+}
@@ -0,0 +1,38 @@
+#ifndef __ACCELERATION_CURVE_H__
+#define __ACCELERATION_CURVE_H__
+
+// Includes:
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+// Macros:
+
+    // Speeds are in px/ms with 8 fractional bits.
+    #define ACCELERATION_CURVE_SPEED_FRACTION_BITS 8
+    #define ACCELERATION_CURVE_SPEED_ONE (1 << ACCELERATION_CURVE_SPEED_FRACTION_BITS)
+
+    // Multipliers are unitless with 16 fractional bits.
+    #define ACCELERATION_CURVE_MULTIPLIER_FRACTION_BITS 16
+    #define ACCELERATION_CURVE_MULTIPLIER_ONE (1 << ACCELERATION_CURVE_MULTIPLIER_FRACTION_BITS)
+
+    // Curve points are spaced by 0.5 px/ms, covering speeds up to 16 px/ms. Faster speeds
+    // extrapolate the last segment.
+    #define ACCELERATION_CURVE_STEP_BITS (ACCELERATION_CURVE_SPEED_FRACTION_BITS - 1)
+    #define ACCELERATION_CURVE_SEGMENT_COUNT 32
+    #define ACCELERATION_CURVE_POINT_COUNT (ACCELERATION_CURVE_SEGMENT_COUNT + 1)
+
+// Typedefs:
+
+    typedef struct {
+        int32_t points[ACCELERATION_CURVE_POINT_COUNT];
+        bool isValid;
+    } acceleration_curve_t;
+
+// Functions:
+
+    void AccelerationCurve_Build(acceleration_curve_t *curve, float baseSpeed, float speed, float xceleration, float midSpeed);
+    int32_t AccelerationCurve_Evaluate(const acceleration_curve_t *curve, uint32_t speed);
+    uint32_t AccelerationCurve_Magnitude(int32_t x, int32_t y);
+
+#endif
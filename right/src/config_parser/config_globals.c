@@ -7,6 +7,8 @@ static uint8_t ATTR_DATA2 stagingUserConfig[USER_CONFIG_SIZE];
 static uint8_t validatedUserConfig[USER_CONFIG_SIZE];
 
 uint16_t ValidatedUserConfigLength;
+uint32_t ValidatedUserConfigCrc;
+uint16_t ValidatedUserConfigCrcLength;
 config_buffer_t HardwareConfigBuffer = { .buffer = hardwareConfig, .offset = 0 };
 config_buffer_t StagingUserConfigBuffer = { .buffer = stagingUserConfig, .offset = 0 };
 config_buffer_t ValidatedUserConfigBuffer = { .buffer = validatedUserConfig, .offset = 0 };
@@ -36,6 +36,8 @@
 
     extern bool ParserRunDry;
     extern uint16_t ValidatedUserConfigLength;
+    extern uint32_t ValidatedUserConfigCrc;
+    extern uint16_t ValidatedUserConfigCrcLength;
     extern config_buffer_t HardwareConfigBuffer;
     extern config_buffer_t StagingUserConfigBuffer;
     extern config_buffer_t ValidatedUserConfigBuffer;
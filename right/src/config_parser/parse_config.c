@@ -14,6 +14,8 @@
     uint16_t DataModelMinorVersion = 0;
     uint16_t DataModelPatchVersion = 0;
 
+    parsed_config_t ParsedConfig;
+
 static parser_error_t parseModuleConfiguration(config_buffer_t *buffer)
 {
     uint8_t id = ReadUInt8(buffer);
@@ -48,9 +50,12 @@ parser_error_t ParseConfig(config_buffer_t *buffer)
     uint16_t keymapCount;
     parser_error_t errorCode;
 
-    DataModelMajorVersion = ReadUInt16(buffer);
-    DataModelMinorVersion = ReadUInt16(buffer);
-    DataModelPatchVersion = ReadUInt16(buffer);
+    ParsedConfig.defaultKeymapIndex = DefaultKeymapIndex;
+    ParsedConfig.macroActionReferenceCount = 0;
+
+    ParsedConfig.dataModelMajorVersion = ReadUInt16(buffer);
+    ParsedConfig.dataModelMinorVersion = ReadUInt16(buffer);
+    ParsedConfig.dataModelPatchVersion = ReadUInt16(buffer);
     uint16_t userConfigLength = ReadUInt16(buffer);
     const char *deviceName = ReadString(buffer, &len);
     uint16_t doubleTapSwitchLayerTimeout = ReadUInt16(buffer);
@@ -134,40 +139,86 @@ parser_error_t ParseConfig(config_buffer_t *buffer)
         }
     }
 
-    // If parsing succeeded then apply the parsed values.
+    // If parsing succeeded then keep the parsed values until the config gets committed.
 
-    if (!ParserRunDry) {
-//        DoubleTapSwitchLayerTimeout = doubleTapSwitchLayerTimeout;
+    ParsedConfig.userConfigLength = userConfigLength;
 
-        // Update LED brightnesses and reinitialize LED drivers
+    ParsedConfig.iconsAndLayerTextsBrightness = iconsAndLayerTextsBrightness;
+    ParsedConfig.alphanumericSegmentsBrightness = alphanumericSegmentsBrightness;
+    ParsedConfig.keyBacklightBrightness = keyBacklightBrightness;
 
-        ValidatedUserConfigLength = userConfigLength;
+    ParsedConfig.mouseMoveInitialSpeed = mouseMoveInitialSpeed;
+    ParsedConfig.mouseMoveAcceleration = mouseMoveAcceleration;
+    ParsedConfig.mouseMoveDeceleratedSpeed = mouseMoveDeceleratedSpeed;
+    ParsedConfig.mouseMoveBaseSpeed = mouseMoveBaseSpeed;
+    ParsedConfig.mouseMoveAcceleratedSpeed = mouseMoveAcceleratedSpeed;
+    ParsedConfig.mouseScrollInitialSpeed = mouseScrollInitialSpeed;
+    ParsedConfig.mouseScrollAcceleration = mouseScrollAcceleration;
+    ParsedConfig.mouseScrollDeceleratedSpeed = mouseScrollDeceleratedSpeed;
+    ParsedConfig.mouseScrollBaseSpeed = mouseScrollBaseSpeed;
+    ParsedConfig.mouseScrollAcceleratedSpeed = mouseScrollAcceleratedSpeed;
 
-        IconsAndLayerTextsBrightnessDefault = iconsAndLayerTextsBrightness;
-        AlphanumericSegmentsBrightnessDefault = alphanumericSegmentsBrightness;
-        KeyBacklightBrightnessDefault = keyBacklightBrightness;
+    ParsedConfig.keymapCount = keymapCount;
+    ParsedConfig.macroCount = macroCount;
 
-        LedSlaveDriver_UpdateLeds();
+    return ParserError_Success;
+}
 
-        // Update mouse key speeds
+// Makes the config that has been validated last the running one. The references that the parser
+// has recorded go live by swapping them with the running ones, so only the keymap that gets
+// switched to has to be decoded again.
+void CommitParsedConfig(void)
+{
+    keymap_reference_t *keymaps = AllKeymaps;
+    AllKeymaps = ParsedKeymaps;
+    ParsedKeymaps = keymaps;
+
+    macro_reference_t *macros = AllMacros;
+    ParsedMacros[MacroIndex_UsbCmdReserved] = macros[MacroIndex_UsbCmdReserved];
+    AllMacros = ParsedMacros;
+    ParsedMacros = macros;
+
+    macro_action_reference_t *macroActions = MacroActionReferences;
+    MacroActionReferences = ParsedMacroActionReferences;
+    ParsedMacroActionReferences = macroActions;
+
+    DataModelMajorVersion = ParsedConfig.dataModelMajorVersion;
+    DataModelMinorVersion = ParsedConfig.dataModelMinorVersion;
+    DataModelPatchVersion = ParsedConfig.dataModelPatchVersion;
+
+    AllKeymapsCount = ParsedConfig.keymapCount;
+    AllMacrosCount = ParsedConfig.macroCount;
+    DefaultKeymapIndex = ParsedConfig.defaultKeymapIndex;
+
+    // The caller switches keymaps afterwards, until then the LED display mustn't refer to a keymap
+    // that is gone.
+    if (CurrentKeymapIndex >= AllKeymapsCount) {
+        CurrentKeymapIndex = 0;
+    }
 
-        MouseMoveState.initialSpeed = mouseMoveInitialSpeed;
-        MouseMoveState.acceleration = mouseMoveAcceleration;
-        MouseMoveState.deceleratedSpeed = mouseMoveDeceleratedSpeed;
-        MouseMoveState.baseSpeed = mouseMoveBaseSpeed;
-        MouseMoveState.acceleratedSpeed = mouseMoveAcceleratedSpeed;
+//    DoubleTapSwitchLayerTimeout = doubleTapSwitchLayerTimeout;
 
-        MouseScrollState.initialSpeed = mouseScrollInitialSpeed;
-        MouseScrollState.acceleration = mouseScrollAcceleration;
-        MouseScrollState.deceleratedSpeed = mouseScrollDeceleratedSpeed;
-        MouseScrollState.baseSpeed = mouseScrollBaseSpeed;
-        MouseScrollState.acceleratedSpeed = mouseScrollAcceleratedSpeed;
+    // Update LED brightnesses and reinitialize LED drivers
 
-        // Update counts
+    ValidatedUserConfigLength = ParsedConfig.userConfigLength;
 
-        AllKeymapsCount = keymapCount;
-        AllMacrosCount = macroCount;
-    }
+    IconsAndLayerTextsBrightnessDefault = ParsedConfig.iconsAndLayerTextsBrightness;
+    AlphanumericSegmentsBrightnessDefault = ParsedConfig.alphanumericSegmentsBrightness;
+    KeyBacklightBrightnessDefault = ParsedConfig.keyBacklightBrightness;
 
-    return ParserError_Success;
+    LedSlaveDriver_UpdateLeds();
+
+    // Update mouse key speeds
+
+    MouseMoveState.initialSpeed = ParsedConfig.mouseMoveInitialSpeed;
+    MouseMoveState.acceleration = ParsedConfig.mouseMoveAcceleration;
+    MouseMoveState.deceleratedSpeed = ParsedConfig.mouseMoveDeceleratedSpeed;
+    MouseMoveState.baseSpeed = ParsedConfig.mouseMoveBaseSpeed;
+    MouseMoveState.acceleratedSpeed = ParsedConfig.mouseMoveAcceleratedSpeed;
+
+    MouseScrollState.initialSpeed = ParsedConfig.mouseScrollInitialSpeed;
+    MouseScrollState.acceleration = ParsedConfig.mouseScrollAcceleration;
+    MouseScrollState.deceleratedSpeed = ParsedConfig.mouseScrollDeceleratedSpeed;
+    MouseScrollState.baseSpeed = ParsedConfig.mouseScrollBaseSpeed;
+    MouseScrollState.acceleratedSpeed = ParsedConfig.mouseScrollAcceleratedSpeed;
 }
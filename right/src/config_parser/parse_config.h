@@ -26,12 +26,41 @@
         ParserError_InvalidLayerId                      = 15,
     } parser_error_t;
 
+    // Whatever ParseConfig finds in a new config, kept aside until CommitParsedConfig.
+    typedef struct {
+        uint16_t dataModelMajorVersion;
+        uint16_t dataModelMinorVersion;
+        uint16_t dataModelPatchVersion;
+        uint16_t userConfigLength;
+        uint8_t iconsAndLayerTextsBrightness;
+        uint8_t alphanumericSegmentsBrightness;
+        uint8_t keyBacklightBrightness;
+        uint8_t mouseMoveInitialSpeed;
+        uint8_t mouseMoveAcceleration;
+        uint8_t mouseMoveDeceleratedSpeed;
+        uint8_t mouseMoveBaseSpeed;
+        uint8_t mouseMoveAcceleratedSpeed;
+        uint8_t mouseScrollInitialSpeed;
+        uint8_t mouseScrollAcceleration;
+        uint8_t mouseScrollDeceleratedSpeed;
+        uint8_t mouseScrollBaseSpeed;
+        uint8_t mouseScrollAcceleratedSpeed;
+        uint8_t keymapCount;
+        uint8_t macroCount;
+        uint8_t defaultKeymapIndex;
+        uint16_t macroActionReferenceCount;
+    } parsed_config_t;
+
+// Variables:
+
     extern uint16_t DataModelMajorVersion;
     extern uint16_t DataModelMinorVersion;
     extern uint16_t DataModelPatchVersion;
+    extern parsed_config_t ParsedConfig;
 
 // Functions:
 
     parser_error_t ParseConfig(config_buffer_t *buffer);
+    void CommitParsedConfig(void);
 
 #endif
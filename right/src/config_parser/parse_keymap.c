@@ -8,6 +8,13 @@
 static uint8_t tempKeymapCount;
 static uint8_t tempMacroCount;
 
+// Keymaps get validated as a part of a new config, and parsed again when the running config
+// switches to them.
+static uint16_t dataModelMajorVersion(void)
+{
+    return ParserRunDry ? ParsedConfig.dataModelMajorVersion : DataModelMajorVersion;
+}
+
 static parser_error_t parseNoneAction(key_action_t *keyAction, config_buffer_t *buffer)
 {
     keyAction->type = KeyActionType_None;
@@ -149,7 +156,7 @@ static parser_error_t parseModule(config_buffer_t *buffer, uint8_t layer)
 
 static parser_error_t parseLayer(config_buffer_t *buffer, uint8_t layer)
 {
-    if(DataModelMajorVersion >= 5) {
+    if(dataModelMajorVersion() >= 5) {
         uint8_t layerId = ReadUInt8(buffer);
         switch(layerId) {
         case SerializedLayerName_base:
@@ -203,16 +210,17 @@ parser_error_t ParseKeymap(config_buffer_t *buffer, uint8_t keymapIdx, uint8_t k
     if (layerCount > LayerId_Count) {
         return ParserError_InvalidLayerCount;
     }
-    if (!ParserRunDry) {
-        AllKeymaps[keymapIdx].abbreviation = abbreviation;
-        AllKeymaps[keymapIdx].abbreviationLen = abbreviationLen;
-        AllKeymaps[keymapIdx].offset = offset;
+    if (ParserRunDry) {
+        ParsedKeymaps[keymapIdx].abbreviation = abbreviation;
+        ParsedKeymaps[keymapIdx].abbreviationLen = abbreviationLen;
+        ParsedKeymaps[keymapIdx].offset = offset;
+        if (isDefault) {
+            ParsedConfig.defaultKeymapIndex = keymapIdx;
+        }
+    } else {
         for (uint8_t layerIdx = 0; layerIdx < LayerId_Count; layerIdx++) {
             LayerConfig[layerIdx].layerIsDefined = false;
         }
-        if (isDefault) {
-            DefaultKeymapIndex = keymapIdx;
-        }
     }
     tempKeymapCount = keymapCount;
     tempMacroCount = macroCount;
@@ -155,21 +155,39 @@ parser_error_t ParseMacro(config_buffer_t *buffer, uint8_t macroIdx)
     uint16_t macroActionsCount = ReadCompactLength(buffer);
     uint16_t firstMacroActionOffset = buffer->offset;
     uint16_t relativeNameOffset = firstMacroActionOffset - nameOffset;
+    uint16_t firstActionReference = MACRO_ACTION_REFERENCE_NONE;
+    uint16_t commandAddress = 0;
     macro_action_t dummyMacroAction;
 
     (void)isLooped;
     (void)isPrivate;
     (void)name;
-    if (!ParserRunDry) {
-        AllMacros[macroIdx].firstMacroActionOffset = firstMacroActionOffset;
-        AllMacros[macroIdx].macroActionsCount = macroActionsCount;
-        AllMacros[macroIdx].macroNameOffset = relativeNameOffset;
+    ParsedMacros[macroIdx].firstMacroActionOffset = firstMacroActionOffset;
+    ParsedMacros[macroIdx].macroActionsCount = macroActionsCount;
+    ParsedMacros[macroIdx].macroNameOffset = relativeNameOffset;
+    if (ParsedConfig.macroActionReferenceCount + macroActionsCount <= MAX_MACRO_ACTION_REFERENCE_COUNT) {
+        firstActionReference = ParsedConfig.macroActionReferenceCount;
+        ParsedConfig.macroActionReferenceCount += macroActionsCount;
     }
     for (uint16_t i = 0; i < macroActionsCount; i++) {
+        uint16_t actionOffset = buffer->offset;
         errorCode = ParseMacroAction(buffer, &dummyMacroAction);
         if (errorCode != ParserError_Success) {
             return errorCode;
         }
+        if (firstActionReference != MACRO_ACTION_REFERENCE_NONE) {
+            // Command addresses are 8 bits wide, macros with more commands are walked sequentially.
+            if (commandAddress > UINT8_MAX) {
+                firstActionReference = MACRO_ACTION_REFERENCE_NONE;
+            } else {
+                ParsedMacroActionReferences[firstActionReference + i] = (macro_action_reference_t){
+                    .offset = actionOffset,
+                    .commandAddress = commandAddress,
+                };
+                commandAddress += dummyMacroAction.type == MacroActionType_Command ? dummyMacroAction.cmd.cmdCount : 1;
+            }
+        }
     }
+    ParsedMacros[macroIdx].firstActionReference = firstActionReference;
     return ParserError_Success;
 }
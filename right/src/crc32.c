@@ -0,0 +1,21 @@
+#include "crc32.h"
+
+// A nibble-wise table is a reasonable compromise between the speed of a full byte-wise table and
+// the flash it would take.
+static const uint32_t nibbleTable[16] = {
+    0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+    0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+    0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+    0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+};
+
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ nibbleTable[crc & 0x0f];
+        crc = (crc >> 4) ^ nibbleTable[crc & 0x0f];
+    }
+    return ~crc;
+}
@@ -0,0 +1,18 @@
+#ifndef __CRC32_H__
+#define __CRC32_H__
+
+// Includes:
+
+    #include <stdint.h>
+
+// Macros:
+
+    #define CRC32_INITIAL_VALUE 0
+
+// Functions:
+
+    // Standard CRC-32 (IEEE 802.3, as used by zlib). Pass CRC32_INITIAL_VALUE, or the result of the
+    // previous call to checksum data in parts.
+    uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length);
+
+#endif
@@ -1,12 +1,20 @@
 #include "fsl_common.h"
+#include "fsl_pit.h"
 #include "config_parser/config_globals.h"
 #include "i2c_addresses.h"
 #include "i2c.h"
 #include "eeprom.h"
 #include "config_parser/config_globals.h"
 #include "buffer.h"
+#include "crc32.h"
+#include "lz4.h"
+#include "peripherals/pit.h"
 
 volatile bool IsEepromBusy;
+uint32_t EepromWritePollCounter;
+uint32_t EepromWriteFailureCounter;
+volatile bool HasEepromWriteFailed;
+bool IsUserConfigCompressionRequested;
 static eeprom_operation_t CurrentEepromOperation;
 static config_buffer_id_t CurrentConfigBufferId;
 static status_t LastEepromTransferStatus;
@@ -14,13 +22,63 @@ void (*SuccessCallback)(void);
 
 static i2c_master_handle_t i2cHandle;
 static i2c_master_transfer_t i2cTransfer;
+static edma_handle_t edmaHandle;
+static i2c_master_edma_handle_t i2cEdmaHandle;
 
 static uint8_t *sourceBuffer;
 static uint16_t sourceOffset;
 static uint16_t eepromStartAddress;
 static uint16_t sourceLength;
 static uint8_t writeLength;
+static uint8_t pollAttempts;
+static uint16_t readOffset;
+static uint16_t readEnd;
 static bool isReadSent;
+static uint8_t pageBuffer[EEPROM_BUFFER_SIZE];
+
+// Checksums of the pages as they are in the EEPROM, known for the pages that have been read or
+// written in full, so that writes can skip the pages that wouldn't change.
+static uint32_t pageChecksums[EEPROM_PAGE_COUNT];
+static uint32_t knownPages[(EEPROM_PAGE_COUNT + 31) / 32];
+
+static bool isPageKnown(uint16_t pageIndex)
+{
+    return knownPages[pageIndex / 32] & (1UL << (pageIndex % 32));
+}
+
+static void setPageChecksum(uint16_t pageIndex, const uint8_t *data)
+{
+    pageChecksums[pageIndex] = CRC32_Update(CRC32_INITIAL_VALUE, data, EEPROM_PAGE_SIZE);
+    knownPages[pageIndex / 32] |= 1UL << (pageIndex % 32);
+}
+
+static void forgetPageChecksum(uint16_t pageIndex)
+{
+    knownPages[pageIndex / 32] &= ~(1UL << (pageIndex % 32));
+}
+
+// Both config areas start at a page boundary.
+static void updatePageChecksums(uint16_t eepromAddress, const uint8_t *data, uint16_t length)
+{
+    for (uint16_t offset = 0; offset + EEPROM_PAGE_SIZE <= length; offset += EEPROM_PAGE_SIZE) {
+        setPageChecksum((eepromAddress + offset) / EEPROM_PAGE_SIZE, data + offset);
+    }
+}
+
+static bool isPageUnchanged(void)
+{
+    uint16_t pageIndex = (eepromStartAddress + sourceOffset) / EEPROM_PAGE_SIZE;
+    return sourceLength - sourceOffset >= EEPROM_PAGE_SIZE
+        && isPageKnown(pageIndex)
+        && pageChecksums[pageIndex] == CRC32_Update(CRC32_INITIAL_VALUE, sourceBuffer + sourceOffset, EEPROM_PAGE_SIZE);
+}
+
+static void skipUnchangedPages(void)
+{
+    while (sourceOffset < sourceLength && isPageUnchanged()) {
+        sourceOffset += EEPROM_PAGE_SIZE;
+    }
+}
 
 static status_t i2cAsyncWrite(uint8_t *data, size_t dataSize)
 {
@@ -28,7 +86,7 @@ static status_t i2cAsyncWrite(uint8_t *data, size_t dataSize)
     i2cTransfer.direction = kI2C_Write;
     i2cTransfer.data = data;
     i2cTransfer.dataSize = dataSize;
-    return I2C_MasterTransferNonBlocking(I2C_EEPROM_BUS_BASEADDR, &i2cHandle, &i2cTransfer);
+    return I2cTransferDma(I2C_EEPROM_BUS_BASEADDR, &i2cEdmaHandle, &i2cHandle, &i2cTransfer);
 }
 
 static status_t i2cAsyncRead(uint8_t *data, size_t dataSize)
@@ -37,51 +95,181 @@ static status_t i2cAsyncRead(uint8_t *data, size_t dataSize)
     i2cTransfer.direction = kI2C_Read;
     i2cTransfer.data = data;
     i2cTransfer.dataSize = dataSize;
-    return I2C_MasterTransferNonBlocking(I2C_EEPROM_BUS_BASEADDR, &i2cHandle, &i2cTransfer);
+    return I2cTransferDma(I2C_EEPROM_BUS_BASEADDR, &i2cEdmaHandle, &i2cHandle, &i2cTransfer);
 }
 
 static status_t writePage(void)
 {
-    static uint8_t buffer[EEPROM_BUFFER_SIZE];
-    SetBufferUint16Be(buffer, 0, eepromStartAddress + sourceOffset);
+    SetBufferUint16Be(pageBuffer, 0, eepromStartAddress + sourceOffset);
     writeLength = MIN(sourceLength - sourceOffset, EEPROM_PAGE_SIZE);
-    memcpy(buffer+EEPROM_ADDRESS_SIZE, sourceBuffer+sourceOffset, writeLength);
-    status_t status = i2cAsyncWrite(buffer, writeLength+EEPROM_ADDRESS_SIZE);
+    memcpy(pageBuffer+EEPROM_ADDRESS_SIZE, sourceBuffer+sourceOffset, writeLength);
+
+    // Until the write is confirmed, the page may hold anything.
+    forgetPageChecksum((eepromStartAddress + sourceOffset) / EEPROM_PAGE_SIZE);
+    status_t status = i2cAsyncWrite(pageBuffer, writeLength+EEPROM_ADDRESS_SIZE);
     return status;
 }
 
+static void startWriteCycleTimer(uint32_t usec)
+{
+    PIT_SetTimerPeriod(PIT, PIT_EEPROM_CHANNEL, USEC_TO_COUNT(usec, PIT_SOURCE_CLOCK));
+    PIT_StartTimer(PIT, PIT_EEPROM_CHANNEL);
+}
+
+static void finishWrite(void)
+{
+    IsEepromBusy = false;
+    if (SuccessCallback) {
+        SuccessCallback();
+    }
+}
+
+// The device doesn't acknowledge its address during a write cycle, so a rejected page means that
+// it is still busy. Retries back off, and give up eventually rather than keep the bus busy forever.
+static void handleRejectedPage(status_t status)
+{
+    EepromWritePollCounter++;
+    if (++pollAttempts > EEPROM_MAX_POLL_ATTEMPTS) {
+        EepromWriteFailureCounter++;
+        HasEepromWriteFailed = true;
+        LastEepromTransferStatus = status;
+        IsEepromBusy = false;
+        return;
+    }
+    startWriteCycleTimer(EEPROM_POLL_INTERVAL_USEC << MIN(pollAttempts - 1, EEPROM_POLL_INTERVAL_MAX_SHIFT));
+}
+
+static void sendPage(void)
+{
+    LastEepromTransferStatus = writePage();
+    if (LastEepromTransferStatus != kStatus_Success) {
+        handleRejectedPage(LastEepromTransferStatus);
+    }
+}
+
+// Fires once the write cycle of the previous page is over, or when it's time to poll again.
+void PIT_EEPROM_HANDLER(void)
+{
+    PIT_StopTimer(PIT, PIT_EEPROM_CHANNEL);
+    PIT_ClearStatusFlags(PIT, PIT_EEPROM_CHANNEL, kPIT_TimerFlag);
+
+    if (sourceOffset < sourceLength) {
+        sendPage();
+    } else {
+        finishWrite();
+    }
+}
+
+static status_t sendReadAddress(void)
+{
+    static uint8_t addressBuffer[EEPROM_ADDRESS_SIZE];
+    SetBufferUint16Be(addressBuffer, 0, eepromStartAddress + readOffset);
+    isReadSent = false;
+    return i2cAsyncWrite(addressBuffer, EEPROM_ADDRESS_SIZE);
+}
+
+// Once the header of the user config is in, only the part that is actually used gets read. Erased
+// or corrupted headers fall back to reading everything.
+static bool extendUserConfigRead(uint8_t *buffer)
+{
+    if (CurrentConfigBufferId == ConfigBufferId_HardwareConfig || readEnd != USER_CONFIG_HEADER_LENGTH) {
+        return false;
+    }
+
+    uint16_t usedLength = GetBufferUint16(buffer, USER_CONFIG_LENGTH_OFFSET);
+    bool isUsedLengthValid = USER_CONFIG_HEADER_LENGTH < usedLength && usedLength <= USER_CONFIG_SIZE;
+    readOffset = USER_CONFIG_HEADER_LENGTH;
+    readEnd = isUsedLengthValid ? usedLength : USER_CONFIG_SIZE;
+    return true;
+}
+
+// The compressed data is moved to the end of the buffer and decompressed towards its start, which
+// the compressor has checked never to overtake the data that is still to be read.
+static status_t decompressUserConfig(uint8_t *buffer)
+{
+    if (CurrentConfigBufferId == ConfigBufferId_HardwareConfig || GetBufferUint16(buffer, 0) != USER_CONFIG_COMPRESSED_MARKER) {
+        return kStatus_Success;
+    }
+
+    uint16_t uncompressedLength = GetBufferUint16(buffer, USER_CONFIG_UNCOMPRESSED_LENGTH_OFFSET);
+    uint16_t compressedLength = readEnd - USER_CONFIG_HEADER_LENGTH;
+    uint8_t *compressedData = buffer + USER_CONFIG_SIZE - compressedLength;
+    memmove(compressedData, buffer + USER_CONFIG_HEADER_LENGTH, compressedLength);
+
+    if (LZ4_Decompress(compressedData, compressedLength, buffer, USER_CONFIG_SIZE) != uncompressedLength) {
+        return kStatus_Fail;
+    }
+    return kStatus_Success;
+}
+
+// The running config points into the validated buffer, so the compressed config is assembled in
+// the staging buffer, whose content is stale after applying. Configs that don't shrink are
+// written as they are.
+static void compressUserConfig(void)
+{
+    uint8_t *compressedConfig = StagingUserConfigBuffer.buffer;
+    uint16_t inPlaceMargin;
+
+    if (sourceLength <= USER_CONFIG_HEADER_LENGTH) {
+        return;
+    }
+
+    uint16_t compressedLength = LZ4_Compress(sourceBuffer, sourceLength, compressedConfig + USER_CONFIG_HEADER_LENGTH, sourceLength - USER_CONFIG_HEADER_LENGTH, &inPlaceMargin);
+
+    if (compressedLength == 0 || compressedLength + inPlaceMargin > USER_CONFIG_SIZE) {
+        return;
+    }
+
+    memset(compressedConfig, 0, USER_CONFIG_HEADER_LENGTH);
+    SetBufferUint16(compressedConfig, 0, USER_CONFIG_COMPRESSED_MARKER);
+    SetBufferUint16(compressedConfig, USER_CONFIG_UNCOMPRESSED_LENGTH_OFFSET, sourceLength);
+    SetBufferUint16(compressedConfig, USER_CONFIG_LENGTH_OFFSET, USER_CONFIG_HEADER_LENGTH + compressedLength);
+    sourceBuffer = compressedConfig;
+    sourceLength = USER_CONFIG_HEADER_LENGTH + compressedLength;
+}
+
 static void i2cCallback(I2C_Type *base, i2c_master_handle_t *handle, status_t status, void *userData)
 {
     LastEepromTransferStatus = status;
 
     switch (CurrentEepromOperation) {
-        case EepromOperation_Read:
-            if (isReadSent) {
-                IsEepromBusy = false;
-                if (SuccessCallback) {
-                    SuccessCallback();
-                }
-                return;
+        case EepromOperation_Read: {
+            uint8_t *buffer = ConfigBufferIdToConfigBuffer(CurrentConfigBufferId)->buffer;
+            if (!isReadSent) {
+                LastEepromTransferStatus = i2cAsyncRead(buffer + readOffset, readEnd - readOffset);
+                IsEepromBusy = true;
+                isReadSent = true;
+                break;
+            }
+            if (status == kStatus_Success && extendUserConfigRead(buffer)) {
+                LastEepromTransferStatus = sendReadAddress();
+                break;
             }
-            LastEepromTransferStatus = i2cAsyncRead(
-                ConfigBufferIdToConfigBuffer(CurrentConfigBufferId)->buffer,
-                CurrentConfigBufferId == ConfigBufferId_HardwareConfig ? HARDWARE_CONFIG_SIZE : USER_CONFIG_SIZE
-            );
-            IsEepromBusy = true;
-            isReadSent = true;
-            break;
-        case EepromOperation_Write:
             if (status == kStatus_Success) {
-                sourceOffset += writeLength;
+                updatePageChecksums(eepromStartAddress, buffer, readEnd);
+                LastEepromTransferStatus = decompressUserConfig(buffer);
             }
-            IsEepromBusy = sourceOffset < sourceLength;
-            if (!IsEepromBusy) {
-                if (SuccessCallback) {
-                    SuccessCallback();
-                }
-                return;
+            IsEepromBusy = false;
+            if (SuccessCallback) {
+                SuccessCallback();
             }
-            LastEepromTransferStatus = writePage();
+            return;
+        }
+        case EepromOperation_Write:
+            if (status != kStatus_Success) {
+                handleRejectedPage(status);
+                break;
+            }
+            // The source may have changed since the page was sent, so the copy that went out is hashed.
+            if (writeLength == EEPROM_PAGE_SIZE) {
+                setPageChecksum((eepromStartAddress + sourceOffset) / EEPROM_PAGE_SIZE, pageBuffer + EEPROM_ADDRESS_SIZE);
+            }
+            sourceOffset += writeLength;
+            skipUnchangedPages();
+            pollAttempts = 0;
+
+            // Even after the last page, stay busy until the device can be accessed again.
+            startWriteCycleTimer(EEPROM_WRITE_CYCLE_TIME_USEC);
             break;
         default:
             IsEepromBusy = false;
@@ -89,9 +277,21 @@ static void i2cCallback(I2C_Type *base, i2c_master_handle_t *handle, status_t st
     }
 }
 
+static void i2cDmaCallback(I2C_Type *base, i2c_master_edma_handle_t *handle, status_t status, void *userData)
+{
+    i2cCallback(base, &i2cHandle, status, userData);
+}
+
 void EEPROM_Init(void)
 {
     I2C_MasterTransferCreateHandle(I2C_EEPROM_BUS_BASEADDR, &i2cHandle, i2cCallback, NULL);
+    I2cInitDma(I2C_EEPROM_BUS_BASEADDR, I2C_EEPROM_BUS_DMA_CHANNEL, I2C_EEPROM_BUS_DMA_REQUEST, &edmaHandle, &i2cEdmaHandle, i2cDmaCallback);
+
+    pit_config_t pitConfig;
+    PIT_GetDefaultConfig(&pitConfig);
+    PIT_Init(PIT, &pitConfig);
+    PIT_EnableInterrupts(PIT, PIT_EEPROM_CHANNEL, kPIT_TimerInterruptEnable);
+    EnableIRQ(PIT_EEPROM_IRQ_ID);
 }
 
 status_t EEPROM_LaunchTransfer(eeprom_operation_t operation, config_buffer_id_t configBufferId, void (*successCallback))
@@ -109,16 +309,28 @@ status_t EEPROM_LaunchTransfer(eeprom_operation_t operation, config_buffer_id_t
 
     switch (CurrentEepromOperation) {
         case EepromOperation_Read:
-            isReadSent = false;
-            static uint8_t addressBuffer[EEPROM_ADDRESS_SIZE];
-            SetBufferUint16Be(addressBuffer, 0, eepromStartAddress);
-            LastEepromTransferStatus = i2cAsyncWrite(addressBuffer, EEPROM_ADDRESS_SIZE);
+            readOffset = 0;
+            readEnd = isHardwareConfig ? HARDWARE_CONFIG_SIZE : USER_CONFIG_HEADER_LENGTH;
+            LastEepromTransferStatus = sendReadAddress();
             break;
         case EepromOperation_Write:
+            HasEepromWriteFailed = false;
             sourceBuffer = ConfigBufferIdToConfigBuffer(CurrentConfigBufferId)->buffer;
             sourceOffset = 0;
             uint16_t userConfigSize = ValidatedUserConfigLength && configBufferId == ConfigBufferId_ValidatedUserConfig ? ValidatedUserConfigLength : USER_CONFIG_SIZE;
             sourceLength = isHardwareConfig ? HARDWARE_CONFIG_SIZE : userConfigSize;
+            if (configBufferId == ConfigBufferId_ValidatedUserConfig && ValidatedUserConfigLength && IsUserConfigCompressionRequested) {
+                compressUserConfig();
+            }
+            skipUnchangedPages();
+            if (sourceOffset >= sourceLength) {
+                // Nothing has changed, so there is nothing to wait for.
+                if (SuccessCallback) {
+                    SuccessCallback();
+                }
+                return kStatus_Success;
+            }
+            pollAttempts = 0;
             LastEepromTransferStatus = writePage();
             break;
     }
@@ -131,3 +343,10 @@ bool IsEepromOperationValid(eeprom_operation_t operation)
 {
     return operation == EepromOperation_Read || operation == EepromOperation_Write;
 }
+
+// A write reads from its source buffer until the last page is out, while reads only touch the
+// buffer that they fill, so only writes keep the config buffers from being swapped or rewritten.
+bool IsEepromWriteInProgress(void)
+{
+    return IsEepromBusy && CurrentEepromOperation == EepromOperation_Write;
+}
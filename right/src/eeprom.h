@@ -14,6 +14,25 @@
     #define EEPROM_ADDRESS_SIZE 2
     #define EEPROM_PAGE_SIZE 64
     #define EEPROM_BUFFER_SIZE (EEPROM_ADDRESS_SIZE + EEPROM_PAGE_SIZE)
+    #define EEPROM_PAGE_COUNT (EEPROM_SIZE / EEPROM_PAGE_SIZE)
+
+    // The user config starts with its data model version and its used length.
+    #define USER_CONFIG_LENGTH_OFFSET 6
+    #define USER_CONFIG_HEADER_LENGTH 8
+
+    // A compressed user config replaces the data model version with a marker that no version can
+    // take, followed by the uncompressed length. The length at USER_CONFIG_LENGTH_OFFSET is the
+    // stored one, so that reads stop after the compressed data.
+    #define USER_CONFIG_COMPRESSED_MARKER 0x5a4c
+    #define USER_CONFIG_UNCOMPRESSED_LENGTH_OFFSET 2
+
+    // The maximum write cycle time of the datasheet, after which the next page is sent.
+    #define EEPROM_WRITE_CYCLE_TIME_USEC 5000
+
+    // Should the device still be busy, it gets polled with exponentially growing intervals.
+    #define EEPROM_POLL_INTERVAL_USEC 250
+    #define EEPROM_POLL_INTERVAL_MAX_SHIFT 3
+    #define EEPROM_MAX_POLL_ATTEMPTS 10
 
 // Typedefs:
 
@@ -25,11 +44,19 @@
 // Variables:
 
     extern volatile bool IsEepromBusy;
+    extern uint32_t EepromWritePollCounter;
+    extern uint32_t EepromWriteFailureCounter;
+    extern volatile bool HasEepromWriteFailed;
+
+    // Firmwares that predate compression take the marker for an unknown data model version and
+    // fail to parse the config, so configs are only compressed for agents that ask for it.
+    extern bool IsUserConfigCompressionRequested;
 
 // Functions:
 
     void EEPROM_Init(void);
     status_t EEPROM_LaunchTransfer(eeprom_operation_t operation, config_buffer_id_t config_buffer_id, void (*successCallback));
     bool IsEepromOperationValid(eeprom_operation_t operation);
+    bool IsEepromWriteInProgress(void);
 
 #endif
@@ -1,9 +1,50 @@
+#include "fsl_dmamux.h"
 #include "i2c.h"
 #include "crc16.h"
 
 i2c_master_handle_t I2cMasterHandle;
 i2c_master_transfer_t masterTransfer;
 
+static edma_handle_t mainBusEdmaHandle;
+static i2c_master_edma_handle_t mainBusI2cEdmaHandle;
+
+void I2cInitDma(I2C_Type *base, uint8_t dmaChannel, dma_request_source_t dmaRequest, edma_handle_t *edmaHandle, i2c_master_edma_handle_t *handle, i2c_master_edma_transfer_callback_t callback)
+{
+    DMAMUX_SetSource(DMAMUX0, dmaChannel, dmaRequest);
+    DMAMUX_EnableChannel(DMAMUX0, dmaChannel);
+    EDMA_CreateHandle(edmaHandle, DMA0, dmaChannel);
+    I2C_MasterCreateEDMAHandle(base, handle, callback, NULL, edmaHandle);
+}
+
+// The KSDK sends the address before handing over to the DMA, and returns a missing acknowledgement
+// right away instead of through the callback, so failed transfers are retried interrupt driven,
+// which reports the error the usual way.
+status_t I2cTransferDma(I2C_Type *base, i2c_master_edma_handle_t *edmaHandle, i2c_master_handle_t *handle, i2c_master_transfer_t *transfer)
+{
+    bool isDmaWorthIt = I2C_DMA_MIN_TRANSFER_SIZE <= transfer->dataSize && transfer->dataSize <= I2C_DMA_MAX_TRANSFER_SIZE;
+    if (isDmaWorthIt && I2C_MasterTransferEDMA(base, edmaHandle, transfer) == kStatus_Success) {
+        return kStatus_Success;
+    }
+    return I2C_MasterTransferNonBlocking(base, handle, transfer);
+}
+
+// DMA transfers don't interrupt until they complete, so they have to feed the watchdog themselves.
+static void mainBusDmaCallback(I2C_Type *base, i2c_master_edma_handle_t *handle, status_t status, void *userData)
+{
+    I2C_Watchdog++;
+    I2cMasterHandle.completionCallback(base, &I2cMasterHandle, status, I2cMasterHandle.userData);
+}
+
+void I2cInitMainBusDma(void)
+{
+    I2cInitDma(I2C_MAIN_BUS_BASEADDR, I2C_MAIN_BUS_DMA_CHANNEL, I2C_MAIN_BUS_DMA_REQUEST, &mainBusEdmaHandle, &mainBusI2cEdmaHandle, mainBusDmaCallback);
+}
+
+void I2cAbortMainBusDma(void)
+{
+    I2C_MasterTransferAbortEDMA(I2C_MAIN_BUS_BASEADDR, &mainBusI2cEdmaHandle);
+}
+
 status_t I2cAsyncWrite(uint8_t i2cAddress, uint8_t *data, size_t dataSize)
 {
     masterTransfer.slaveAddress = i2cAddress;
@@ -14,6 +55,16 @@ status_t I2cAsyncWrite(uint8_t i2cAddress, uint8_t *data, size_t dataSize)
     return I2C_MasterTransferNonBlocking(I2C_MAIN_BUS_BASEADDR, &I2cMasterHandle, &masterTransfer);
 }
 
+status_t I2cAsyncWriteDma(uint8_t i2cAddress, uint8_t *data, size_t dataSize)
+{
+    masterTransfer.slaveAddress = i2cAddress;
+    masterTransfer.direction = kI2C_Write;
+    masterTransfer.data = data;
+    masterTransfer.dataSize = dataSize;
+    I2cMasterHandle.userData = NULL;
+    return I2cTransferDma(I2C_MAIN_BUS_BASEADDR, &mainBusI2cEdmaHandle, &I2cMasterHandle, &masterTransfer);
+}
+
 status_t I2cAsyncWriteMessage(uint8_t i2cAddress, i2c_message_t *message)
 {
     masterTransfer.slaveAddress = i2cAddress;
@@ -35,6 +86,23 @@ status_t I2cAsyncRead(uint8_t i2cAddress, uint8_t *data, size_t dataSize)
     return I2C_MasterTransferNonBlocking(I2C_MAIN_BUS_BASEADDR, &I2cMasterHandle, &masterTransfer);
 }
 
+// Writes the register address and reads the data in a single transfer, using a repeated start
+// inbetween, so that devices with auto-incrementing register pointers can be read in one burst.
+status_t I2cAsyncReadRegisters(uint8_t i2cAddress, uint32_t registerAddress, uint8_t registerAddressSize, uint8_t *data, size_t dataSize)
+{
+    masterTransfer.slaveAddress = i2cAddress;
+    masterTransfer.direction = kI2C_Read;
+    masterTransfer.subaddress = registerAddress;
+    masterTransfer.subaddressSize = registerAddressSize;
+    masterTransfer.data = data;
+    masterTransfer.dataSize = dataSize;
+    I2cMasterHandle.userData = NULL;
+    status_t status = I2C_MasterTransferNonBlocking(I2C_MAIN_BUS_BASEADDR, &I2cMasterHandle, &masterTransfer);
+    masterTransfer.subaddress = 0;
+    masterTransfer.subaddressSize = 0;
+    return status;
+}
+
 status_t I2cAsyncReadMessage(uint8_t i2cAddress, i2c_message_t *message)
 {
     masterTransfer.slaveAddress = i2cAddress;
@@ -4,6 +4,7 @@
 // Includes:
 
     #include "fsl_i2c.h"
+    #include "fsl_i2c_edma.h"
     #include "slave_protocol.h"
 
 // Macros:
@@ -17,6 +18,10 @@
     #define I2C_MAIN_BUS_BUSPAL_BAUD_RATE 30000
     #define I2C_MAIN_BUS_MUX              kPORT_MuxAlt7
 
+    #define I2C_MAIN_BUS_DMA_CHANNEL      0
+    #define I2C_MAIN_BUS_DMA_REQUEST      kDmaRequestMux0I2C0
+    #define I2C_MAIN_BUS_DMA_IRQ_ID       DMA0_IRQn
+
     #define I2C_MAIN_BUS_SDA_GPIO  GPIOD
     #define I2C_MAIN_BUS_SDA_PORT  PORTD
     #define I2C_MAIN_BUS_SDA_CLOCK kCLOCK_PortD
@@ -35,6 +40,10 @@
     #define I2C_EEPROM_BUS_BAUD_RATE 1000000  // 1 Mhz is the maximum speed of the EEPROM.
     #define I2C_EEPROM_BUS_MUX       kPORT_MuxAlt2
 
+    #define I2C_EEPROM_BUS_DMA_CHANNEL 1
+    #define I2C_EEPROM_BUS_DMA_REQUEST kDmaRequestMux0I2C1
+    #define I2C_EEPROM_BUS_DMA_IRQ_ID  DMA1_IRQn
+
     #define I2C_EEPROM_BUS_SDA_GPIO  GPIOC
     #define I2C_EEPROM_BUS_SDA_PORT  PORTC
     #define I2C_EEPROM_BUS_SDA_CLOCK kCLOCK_PortC
@@ -45,6 +54,13 @@
     #define I2C_EEPROM_BUS_SCL_CLOCK kCLOCK_PortC
     #define I2C_EEPROM_BUS_SCL_PIN   10
 
+    // Shorter transfers are interrupt driven, because setting up the DMA would take longer than
+    // clocking out the few bytes.
+    #define I2C_DMA_MIN_TRANSFER_SIZE 8
+
+    // Limited by the major loop counter of the DMA.
+    #define I2C_DMA_MAX_TRANSFER_SIZE DMA_CITER_ELINKNO_CITER_MASK
+
 // Variables:
 
     extern i2c_master_handle_t I2cMasterHandle;
@@ -53,7 +69,14 @@
 
     status_t I2cAsyncWrite(uint8_t i2cAddress, uint8_t *data, size_t dataSize);
     status_t I2cAsyncRead(uint8_t i2cAddress, uint8_t *data, size_t dataSize);
+    status_t I2cAsyncReadRegisters(uint8_t i2cAddress, uint32_t registerAddress, uint8_t registerAddressSize, uint8_t *data, size_t dataSize);
     status_t I2cAsyncWriteMessage(uint8_t i2cAddress, i2c_message_t *message);
     status_t I2cAsyncReadMessage(uint8_t i2cAddress, i2c_message_t *message);
+    status_t I2cAsyncWriteDma(uint8_t i2cAddress, uint8_t *data, size_t dataSize);
+
+    void I2cInitDma(I2C_Type *base, uint8_t dmaChannel, dma_request_source_t dmaRequest, edma_handle_t *edmaHandle, i2c_master_edma_handle_t *handle, i2c_master_edma_transfer_callback_t callback);
+    status_t I2cTransferDma(I2C_Type *base, i2c_master_edma_handle_t *edmaHandle, i2c_master_handle_t *handle, i2c_master_transfer_t *transfer);
+    void I2cInitMainBusDma(void);
+    void I2cAbortMainBusDma(void);
 
 #endif
@@ -1,5 +1,7 @@
 #include "fsl_common.h"
 #include "fsl_port.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
 #include "config.h"
 #include "peripherals/test_led.h"
 #include "peripherals/reset_button.h"
@@ -62,11 +64,14 @@ static void initBusPalState(void) {
 
 static void initInterruptPriorities(void)
 {
-    NVIC_SetPriority(PIT_I2C_WATCHDOG_IRQ_ID,  1);
-    NVIC_SetPriority(I2C_EEPROM_BUS_IRQ_ID,    0);
-    NVIC_SetPriority(PIT_TIMER_IRQ_ID,         3);
-    NVIC_SetPriority(I2C_MAIN_BUS_IRQ_ID,      4);
-    NVIC_SetPriority(USB_IRQ_ID,               4);
+    NVIC_SetPriority(PIT_I2C_WATCHDOG_IRQ_ID,   1);
+    NVIC_SetPriority(I2C_EEPROM_BUS_IRQ_ID,     0);
+    NVIC_SetPriority(I2C_EEPROM_BUS_DMA_IRQ_ID, 0);
+    NVIC_SetPriority(PIT_EEPROM_IRQ_ID,         0);
+    NVIC_SetPriority(PIT_TIMER_IRQ_ID,          3);
+    NVIC_SetPriority(I2C_MAIN_BUS_IRQ_ID,       4);
+    NVIC_SetPriority(I2C_MAIN_BUS_DMA_IRQ_ID,   4);
+    NVIC_SetPriority(USB_IRQ_ID,                4);
 }
 
 static void delay(void)
@@ -132,15 +137,25 @@ static void initI2cBus(i2c_bus_t *i2cBus)
 
 void ReinitI2cMainBus(void)
 {
+    I2cAbortMainBusDma();
     I2C_MasterDeinit(I2C_MAIN_BUS_BASEADDR);
     initI2cBus(&i2cMainBus);
     InitSlaveScheduler();
 }
 
+static void initDma(void)
+{
+    edma_config_t edmaConfig;
+    EDMA_GetDefaultConfig(&edmaConfig);
+    EDMA_Init(DMA0, &edmaConfig);
+    DMAMUX_Init(DMAMUX0);
+}
+
 static void initI2c(void)
 {
     initI2cBus(&i2cMainBus);
     initI2cBus(&i2cEepromBus);
+    I2cInitMainBusDma();
 }
 
 void InitPeripherals(void)
@@ -152,6 +167,7 @@ void InitPeripherals(void)
     InitResetButton();
     InitMergeSensor();
     ADC_Init();
+    initDma();
     initI2c();
     TestLed_Init();
     LedPwm_Init();
@@ -19,6 +19,7 @@
         KeyActionType_SwitchLayer,
         KeyActionType_SwitchKeymap,
         KeyActionType_PlayMacro,
+        KeyActionType_OneShotModifiers,
     } key_action_type_t;
 
     typedef enum {
@@ -31,6 +32,7 @@
         SwitchLayerMode_HoldAndDoubleTapToggle,
         SwitchLayerMode_Toggle,
         SwitchLayerMode_Hold,
+        SwitchLayerMode_OneShot,
     } switch_layer_mode_t;
 
     typedef enum {
@@ -64,6 +66,9 @@
             struct {
                 uint8_t macroId;
             } ATTR_PACKED playMacro;
+            struct {
+                uint8_t modifiers;
+            } ATTR_PACKED oneShotModifiers;
         };
     } ATTR_PACKED key_action_t;
 
@@ -7,14 +7,19 @@
 #include "config_parser/config_globals.h"
 #include "macros.h"
 #include "macro_events.h"
+#include "slave_drivers/is31fl3xxx_driver.h"
 
-keymap_reference_t AllKeymaps[MAX_KEYMAP_NUM] = {
+static keymap_reference_t keymapReferences[MAX_KEYMAP_NUM] = {
     {
         .abbreviation = "FTY",
         .offset = 0,
         .abbreviationLen = 3
     }
 };
+static keymap_reference_t ATTR_DATA2 parsedKeymapReferences[MAX_KEYMAP_NUM];
+
+keymap_reference_t *AllKeymaps = keymapReferences;
+keymap_reference_t *ParsedKeymaps = parsedKeymapReferences;
 
 uint8_t AllKeymapsCount;
 uint8_t DefaultKeymapIndex;
@@ -25,8 +30,10 @@ void SwitchKeymapById(uint8_t index)
     CurrentKeymapIndex = index;
     ValidatedUserConfigBuffer.offset = AllKeymaps[index].offset;
     ParseKeymap(&ValidatedUserConfigBuffer, index, AllKeymapsCount, AllMacrosCount);
+    LedSlaveDriver_BeginFrame();
     LedDisplay_UpdateText();
     UpdateLayerLeds();
+    LedSlaveDriver_EndFrame();
     MacroEvent_OnKeymapChange(index);
 }
 
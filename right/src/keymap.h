@@ -21,7 +21,8 @@
 
 // Variables:
 
-    extern keymap_reference_t AllKeymaps[MAX_KEYMAP_NUM];
+    extern keymap_reference_t *AllKeymaps;
+    extern keymap_reference_t *ParsedKeymaps;
     extern uint8_t AllKeymapsCount;
     extern uint8_t DefaultKeymapIndex;
     extern uint8_t CurrentKeymapIndex;
@@ -5,10 +5,12 @@
 #include "macros.h"
 #include "debug.h"
 #include "led_display.h"
+#include "slave_drivers/is31fl3xxx_driver.h"
 #include "usb_report_updater.h"
 
 uint16_t DoubleTapSwitchLayerTimeout = 400;
 uint16_t DoubleTapSwitchLayerReleaseTimeout = 200;
+uint16_t OneShotTimeout = 0;
 
 layer_id_t ActiveLayer = LayerId_Base;
 bool ActiveLayerHeld = false;
@@ -18,19 +20,23 @@ uint8_t ActiveLayerModifierMask = 0;
 
 static layer_id_t toggledLayer = NONE;
 static layer_id_t heldLayer = NONE;
+static layer_id_t oneShotLayer = NONE;
+static layer_id_t ledLayer = LayerId_Base;
 
 
 /**
  * General logic.
  *
- * There are three types of actions:
+ * There are four types of actions:
  * - layer holds
  * - layer toggles
+ * - one-shot layers
  * - secondary layer hold
  *
  * Requirements:
  * - Superiority:
  *   - Toggled layers are superior to layer holds.
+ *   - Armed one-shot layers are superior to layer holds, but inferior to toggles.
  * - Evaluation:
  *   - Toggles are triggered by key presses/releases and behave as standard actions.
  *   - Standard holds are evaluated continuously in "background" irrespectively
@@ -58,6 +64,9 @@ void updateActiveLayer() {
     if(activeLayer == NONE) {
         activeLayer = toggledLayer;
     }
+    if(activeLayer == NONE) {
+        activeLayer = oneShotLayer;
+    }
     if(activeLayer == NONE) {
         activeLayer = heldLayer;
     }
@@ -77,8 +86,6 @@ void updateActiveLayer() {
     //(write actual ActiveLayer atomically, so that random observer is not confused)
     ActiveLayer = activeLayer;
     ActiveLayerHeld = activeLayerHeld;
-    UpdateLayerLeds();
-    LedDisplay_SetLayer(ActiveLayer);
 }
 
 /*
@@ -129,6 +136,70 @@ void LayerSwitcher_DoubleTapInterrupt(key_state_t* keyState) {
     }
 }
 
+/*
+ * One-shot handlers
+ *
+ * While held, one-shot layer switcher behaves as a standard hold (see applyLayerHolds).
+ * If it is released without any other key having been activated meanwhile, the layer
+ * gets armed and stays active for exactly one following key activation. Armed layer is
+ * dropped after OneShotTimeout (if nonzero).
+ */
+
+static key_state_t *oneShotLayerKey;
+static bool oneShotLayerInterrupted;
+static uint32_t oneShotLayerArmedTime;
+
+void LayerSwitcher_OneShot(layer_id_t layer, key_state_t* keyState) {
+    if(KeyState_ActivatedNow(keyState)) {
+        oneShotLayerKey = keyState;
+        oneShotLayerInterrupted = false;
+        if (oneShotLayer != NONE) {
+            oneShotLayer = NONE;
+            updateActiveLayer();
+        }
+    }
+
+    if(KeyState_DeactivatedNow(keyState)) {
+        if (oneShotLayerKey == keyState && !oneShotLayerInterrupted) {
+            oneShotLayer = layer;
+            oneShotLayerArmedTime = CurrentTime;
+            updateActiveLayer();
+        }
+        oneShotLayerKey = NULL;
+    }
+}
+
+// Called after the action of the activated key has been cached, so the armed layer
+// has already been applied to it and can be consumed. One-shot modifier and layer keys
+// don't consume it, so that one-shots can be chained.
+void LayerSwitcher_OneShotInterrupt(key_state_t* keyState, key_action_t* action) {
+    if (keyState == oneShotLayerKey) {
+        return;
+    }
+    oneShotLayerInterrupted = true;
+    if (oneShotLayer == NONE) {
+        return;
+    }
+
+    switch (action->type) {
+        case KeyActionType_OneShotModifiers:
+        case KeyActionType_SwitchLayer:
+        case KeyActionType_None:
+            return;
+        default:
+            oneShotLayer = NONE;
+            updateActiveLayer();
+            break;
+    }
+}
+
+static void handleOneShotTimeout() {
+    if (oneShotLayer != NONE && OneShotTimeout && Timer_GetElapsedTime(&oneShotLayerArmedTime) > OneShotTimeout) {
+        oneShotLayer = NONE;
+        updateActiveLayer();
+    }
+}
+
 void LayerSwitcher_ToggleLayer(layer_id_t layer) {
     if(toggledLayer == NONE) {
         toggledLayer = layer;
@@ -197,6 +268,8 @@ static bool layerMeetsHoldConditions(uint8_t layer, uint8_t* maskOutput) {
 void LayerSwitcher_UpdateActiveLayer() {
     layer_id_t previousHeldLayer = heldLayer;
 
+    handleOneShotTimeout();
+
     // Include macro held layer into computation
     if (Macros_ActiveLayer != NONE && Macros_ActiveLayerHeld) {
         heldLayers[Macros_ActiveLayer] = true;
@@ -222,6 +295,16 @@ void LayerSwitcher_UpdateActiveLayer() {
     if (previousHeldLayer != heldLayer) {
         updateActiveLayer();
     }
+
+    // The layer may change several times within a cycle, so the LEDs are refreshed here, at most
+    // once per cycle, and only where the colours actually differ.
+    if (ledLayer != ActiveLayer) {
+        ledLayer = ActiveLayer;
+        LedSlaveDriver_BeginFrame();
+        UpdateLayerLedsIncrementally();
+        LedDisplay_SetLayer(ActiveLayer);
+        LedSlaveDriver_EndFrame();
+    }
 }
 
 /**
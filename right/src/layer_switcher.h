@@ -5,6 +5,7 @@
 
     #include "fsl_common.h"
     #include "key_states.h"
+    #include "key_action.h"
     #include "layer.h"
 
 // Macros:
@@ -14,12 +15,15 @@
     extern layer_id_t ActiveLayer;
     extern bool ActiveLayerHeld;
     extern uint16_t DoubleTapSwitchLayerTimeout;
+    extern uint16_t OneShotTimeout;
 
 // Functions - event triggers:
 
     void LayerSwitcher_HoldLayer(layer_id_t layer, bool forceSwap);
     void LayerSwitcher_DoubleTapToggle(layer_id_t layer, key_state_t* keyState);
     void LayerSwitcher_DoubleTapInterrupt(key_state_t* keyState);
+    void LayerSwitcher_OneShot(layer_id_t layer, key_state_t* keyState);
+    void LayerSwitcher_OneShotInterrupt(key_state_t* keyState, key_action_t* action);
     void LayerSwitcher_ToggleLayer(layer_id_t layer);
     void LayerSwitcher_UnToggleLayerOnly(layer_id_t layer);
 
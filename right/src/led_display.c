@@ -146,22 +146,24 @@ static const uint8_t segmentLedIds[maxSegmentChars][ledCountPerChar] = {
 
 void LedDisplay_SetText(uint8_t length, const char* text)
 {
+    LedSlaveDriver_BeginFrame();
     for (uint8_t charId=0; charId<LED_DISPLAY_KEYMAP_NAME_LENGTH; charId++) {
         char keymapChar = charId < length ? text[charId] : ' ';
         uint16_t charBits = letterToSegmentMap[keymapChar - ' '];
         for (uint8_t ledId=0; ledId<ledCountPerChar; ledId++) {
             uint8_t ledIdx = segmentLedIds[charId][ledId];
             bool isLedOn = charBits & (1 << ledId);
-            LedDriverValues[LedDriverId_Left][ledIdx] = isLedOn ? AlphanumericSegmentsBrightness : 0;
+            LedSlaveDriver_SetLedValue(LedDriverId_Left, ledIdx, isLedOn ? AlphanumericSegmentsBrightness : 0);
         }
     }
+    LedSlaveDriver_EndFrame();
 }
 
 void LedDisplay_SetLayer(layer_id_t layerId)
 {
     // layerLedIds is defined for just three values atm
     for (uint8_t i=1; i<4; i++) {
-        LedDriverValues[LedDriverId_Left][layerLedIds[i-1]] = layerId == i ? IconsAndLayerTextsBrightness : 0;
+        LedSlaveDriver_SetLedValue(LedDriverId_Left, layerLedIds[i-1], layerId == i ? IconsAndLayerTextsBrightness : 0);
     }
 }
 
@@ -173,7 +175,7 @@ bool LedDisplay_GetIcon(led_display_icon_t icon)
 void LedDisplay_SetIcon(led_display_icon_t icon, bool isEnabled)
 {
     ledIconStates[icon] = isEnabled;
-    LedDriverValues[LedDriverId_Left][iconLedIds[icon]] = isEnabled ? IconsAndLayerTextsBrightness : 0;
+    LedSlaveDriver_SetLedValue(LedDriverId_Left, iconLedIds[icon], isEnabled ? IconsAndLayerTextsBrightness : 0);
 }
 
 void LedDisplay_UpdateIcons(void)
@@ -195,7 +197,9 @@ void LedDisplay_UpdateText(void)
 
 void LedDisplay_UpdateAll(void)
 {
+    LedSlaveDriver_BeginFrame();
     LedDisplay_UpdateIcons();
     LedDisplay_SetLayer(ActiveLayer);
     LedDisplay_UpdateText();
+    LedSlaveDriver_EndFrame();
 }
@@ -1,3 +1,4 @@
+#include <math.h>
 #include "keymap.h"
 #include "layer_switcher.h"
 #include "ledmap.h"
@@ -9,6 +10,7 @@
 #define RGB(R, G, B) { .red = (R), .green = (G), .blue = (B)}
 
 rgb_t LedMap_ConstantRGB = RGB(0xFF, 0xFF, 0xFF);
+float LedMap_Gamma = 1.0f;
 
 #if DEVICE_ID == DEVICE_ID_UHK60V2
 
@@ -146,16 +148,57 @@ static rgb_t LedMap[SLOT_COUNT][MAX_KEY_COUNT_PER_MODULE] = {
     },
 };
 
+// All channels share the gamma, so only the green of the left module, which is driven at half
+// brightness, needs a table of its own.
+typedef enum {
+    ColorTable_Key,
+    ColorTable_ModuleGreen,
+    ColorTable_Count,
+} color_table_t;
+
+static uint8_t colorTables[ColorTable_Count][256];
+static uint8_t colorTablesBrightness;
+static float colorTablesGamma;
+static bool colorTablesAreValid;
+
+// Colour classes of the keys as last written by the functional strategy, so that a layer switch
+// only rewrites the keys whose colour changes.
+static uint8_t appliedKeyActionColors[SLOT_COUNT][MAX_KEY_COUNT_PER_MODULE];
+static bool appliedKeyActionColorsAreValid;
+
+// Maps colour components to PWM values, so that a refresh doesn't have to do any arithmetic per
+// key. Rebuilt only when the brightness, which also reflects the sleep state, or the gamma changes.
+// Returns true if the tables changed.
+static bool updateColorTables(void)
+{
+    if (colorTablesAreValid && colorTablesBrightness == KeyBacklightBrightness && colorTablesGamma == LedMap_Gamma) {
+        return false;
+    }
+
+    for (uint16_t component=0; component<256; component++) {
+        uint32_t correctedComponent = LedMap_Gamma == 1.0f
+            ? component
+            : (uint32_t)(255.0f * powf(component / 255.0f, LedMap_Gamma) + 0.5f);
+        colorTables[ColorTable_Key][component] = correctedComponent * KeyBacklightBrightness / 255;
+        colorTables[ColorTable_ModuleGreen][component] = correctedComponent * KeyBacklightBrightness / 2 / 255;
+    }
+
+    colorTablesBrightness = KeyBacklightBrightness;
+    colorTablesGamma = LedMap_Gamma;
+    colorTablesAreValid = true;
+    return true;
+}
+
 static void setPerKeyRGB(const rgb_t* color, uint8_t slotId, uint8_t keyId)
 {
     const rgb_t *ledMapItem = &LedMap[slotId][keyId];
     if (ledMapItem->red == 0 && ledMapItem->green == 0 && ledMapItem->blue == 0) {
         return;
     }
-    LedDriverValues[slotId][ledMapItem->red] = color->red * KeyBacklightBrightness / 255;
-    float brightnessDivisor = slotId == SlotId_LeftModule ? 2 : 1;
-    LedDriverValues[slotId][ledMapItem->green] = color->green * KeyBacklightBrightness / brightnessDivisor / 255;
-    LedDriverValues[slotId][ledMapItem->blue] = color->blue * KeyBacklightBrightness / 255;
+    const uint8_t *greenTable = colorTables[slotId == SlotId_LeftModule ? ColorTable_ModuleGreen : ColorTable_Key];
+    LedSlaveDriver_SetLedValue(slotId, ledMapItem->red, colorTables[ColorTable_Key][color->red]);
+    LedSlaveDriver_SetLedValue(slotId, ledMapItem->green, greenTable[color->green]);
+    LedSlaveDriver_SetLedValue(slotId, ledMapItem->blue, colorTables[ColorTable_Key][color->blue]);
 }
 
 static void updateLedsByConstantRgbStrategy() {
@@ -166,60 +209,88 @@ static void updateLedsByConstantRgbStrategy() {
     }
 }
 
-static void updateLedsByFunctionalStrategy() {
-    for (uint8_t slotId=0; slotId<SLOT_COUNT; slotId++) {
-        for (uint8_t keyId=0; keyId<MAX_KEY_COUNT_PER_MODULE; keyId++) {
-            key_action_color_t keyActionColor;
-            key_action_t *keyAction = &CurrentKeymap[ActiveLayer][slotId][keyId];
+static key_action_color_t getKeyActionColor(uint8_t slotId, uint8_t keyId)
+{
+    key_action_t *keyAction = &CurrentKeymap[ActiveLayer][slotId][keyId];
+
+    if (keyAction->type == KeyActionType_None && IS_MODIFIER_LAYER(ActiveLayer)) {
+        keyAction = &CurrentKeymap[LayerId_Base][slotId][keyId];
+    }
 
-            if (keyAction->type == KeyActionType_None && IS_MODIFIER_LAYER(ActiveLayer)) {
-                keyAction = &CurrentKeymap[LayerId_Base][slotId][keyId];
+    switch (keyAction->type) {
+        case KeyActionType_Keystroke:
+            if (keyAction->keystroke.scancode && keyAction->keystroke.modifiers) {
+                return KeyActionColor_Shortcut;
+            } else if (keyAction->keystroke.modifiers) {
+                return KeyActionColor_Modifier;
+            } else {
+                return KeyActionColor_Scancode;
             }
+        case KeyActionType_SwitchLayer:
+            return KeyActionColor_SwitchLayer;
+        case KeyActionType_Mouse:
+            return KeyActionColor_Mouse;
+        case KeyActionType_SwitchKeymap:
+            return KeyActionColor_SwitchKeymap;
+        case KeyActionType_PlayMacro:
+            return KeyActionColor_Macro;
+        case KeyActionType_OneShotModifiers:
+            return KeyActionColor_Modifier;
+        default:
+            return KeyActionColor_None;
+    }
+}
 
-            switch (keyAction->type) {
-                case KeyActionType_Keystroke:
-                    if (keyAction->keystroke.scancode && keyAction->keystroke.modifiers) {
-                        keyActionColor = KeyActionColor_Shortcut;
-                    } else if (keyAction->keystroke.modifiers) {
-                        keyActionColor = KeyActionColor_Modifier;
-                    } else {
-                        keyActionColor = KeyActionColor_Scancode;
-                    }
-                    break;
-                case KeyActionType_SwitchLayer:
-                    keyActionColor = KeyActionColor_SwitchLayer;
-                    break;
-                case KeyActionType_Mouse:
-                    keyActionColor = KeyActionColor_Mouse;
-                    break;
-                case KeyActionType_SwitchKeymap:
-                    keyActionColor = KeyActionColor_SwitchKeymap;
-                    break;
-                case KeyActionType_PlayMacro:
-                    keyActionColor = KeyActionColor_Macro;
-                    break;
-                default:
-                    keyActionColor = KeyActionColor_None;
-                    break;
+static void updateLedsByFunctionalStrategy(bool incremental) {
+    for (uint8_t slotId=0; slotId<SLOT_COUNT; slotId++) {
+        for (uint8_t keyId=0; keyId<MAX_KEY_COUNT_PER_MODULE; keyId++) {
+            key_action_color_t keyActionColor = getKeyActionColor(slotId, keyId);
+
+            if (incremental && appliedKeyActionColors[slotId][keyId] == keyActionColor) {
+                continue;
             }
 
+            appliedKeyActionColors[slotId][keyId] = keyActionColor;
             setPerKeyRGB(&KeyActionColors[keyActionColor], slotId, keyId);
         }
     }
+    appliedKeyActionColorsAreValid = true;
 }
 
-void UpdateLayerLeds(void) {
+static void updateLayerLeds(bool incremental) {
+    if (updateColorTables()) {
+        incremental = false;
+    }
+
+    LedSlaveDriver_BeginFrame();
+
     switch (LedMap_BacklightStrategy) {
         case BacklightStrategy_Functional:
-            updateLedsByFunctionalStrategy();
+            updateLedsByFunctionalStrategy(incremental && appliedKeyActionColorsAreValid);
             break;
         case BacklightStrategy_ConstantRGB:
-            updateLedsByConstantRgbStrategy();
+            // The colour doesn't depend on the layer.
+            if (!incremental) {
+                updateLedsByConstantRgbStrategy();
+            }
             break;
     }
+    LedSlaveDriver_EndFrame();
+}
+
+void UpdateLayerLeds(void) {
+    updateLayerLeds(false);
+}
+
+// Only rewrites keys whose colour changed since the last update, meant for layer switches.
+void UpdateLayerLedsIncrementally(void) {
+    updateLayerLeds(true);
 }
 
 void InitLedLayout(void) {
+    updateColorTables();
+    appliedKeyActionColorsAreValid = false;
+
     // clear the RGB first, since the default mapping will no longer be reachable
     setPerKeyRGB(&black, SlotId_LeftKeyboardHalf, LedMapIndex_LeftSlot_IsoKey);
 
@@ -237,6 +308,7 @@ void InitLedLayout(void) {
 void SetLedBacklightStrategy(backlight_strategy_t newStrategy)
 {
     LedMap_BacklightStrategy = newStrategy;
+    appliedKeyActionColorsAreValid = false;
 }
 
 #else /* DEVICE_ID == DEVICE_ID_UHK60V2 */
@@ -245,6 +317,10 @@ void UpdateLayerLeds(void)
 {
 }
 
+void UpdateLayerLedsIncrementally(void)
+{
+}
+
 void InitLedLayout(void)
 {
 }
@@ -5,6 +5,11 @@
 
     #include "key_action.h"
 
+// Macros:
+
+    #define LED_MAP_GAMMA_MIN 0.1f
+    #define LED_MAP_GAMMA_MAX 4.0f
+
 // Typedefs:
     typedef enum {
         BacklightStrategy_Functional,
@@ -36,10 +41,12 @@
 // Variables:
 
     extern rgb_t LedMap_ConstantRGB;
+    extern float LedMap_Gamma;
 
 // Functions:
 
     void UpdateLayerLeds(void);
+    void UpdateLayerLedsIncrementally(void);
     void InitLedLayout(void);
     void SetLedBacklightStrategy(backlight_strategy_t newStrategy);
 
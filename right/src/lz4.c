@@ -0,0 +1,187 @@
+#include "fsl_common.h"
+#include "lz4.h"
+
+// Required by the block format, so that standard decoders can copy in bulk.
+#define LAST_LITERALS 5
+#define MATCH_FIND_LIMIT 12
+
+#define RUN_MASK 0x0f
+#define MAX_EXTENDED_LENGTH UINT16_MAX
+
+static uint16_t hashTable[1 << LZ4_HASH_BITS];
+
+static uint32_t readUint32(const uint8_t *data)
+{
+    return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24;
+}
+
+static uint16_t hashSequence(uint32_t sequence)
+{
+    return (uint32_t)(sequence * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+static uint8_t *writeExtendedLength(uint8_t *out, const uint8_t *outEnd, uint16_t length)
+{
+    for (; length >= 255; length -= 255) {
+        if (out >= outEnd) {
+            return NULL;
+        }
+        *out++ = 255;
+    }
+    if (out >= outEnd) {
+        return NULL;
+    }
+    *out++ = length;
+    return out;
+}
+
+// A match length of zero ends the block with literals only.
+static uint8_t *writeSequence(uint8_t *out, const uint8_t *outEnd, const uint8_t *literals, uint16_t literalLength, uint16_t matchLength, uint16_t offset)
+{
+    uint16_t storedMatchLength = matchLength ? matchLength - LZ4_MIN_MATCH : 0;
+    uint8_t *token = out++;
+
+    if (token >= outEnd) {
+        return NULL;
+    }
+    *token = MIN(literalLength, RUN_MASK) << 4 | MIN(storedMatchLength, RUN_MASK);
+
+    if (literalLength >= RUN_MASK && !(out = writeExtendedLength(out, outEnd, literalLength - RUN_MASK))) {
+        return NULL;
+    }
+    if (outEnd - out < literalLength) {
+        return NULL;
+    }
+    memcpy(out, literals, literalLength);
+    out += literalLength;
+
+    if (matchLength == 0) {
+        return out;
+    }
+    if (outEnd - out < 2) {
+        return NULL;
+    }
+    *out++ = offset;
+    *out++ = offset >> 8;
+    if (storedMatchLength >= RUN_MASK && !(out = writeExtendedLength(out, outEnd, storedMatchLength - RUN_MASK))) {
+        return NULL;
+    }
+    return out;
+}
+
+// Greedy parsing with a single candidate per hash, which is fast and still compresses the
+// repetitive parts of configs well.
+uint16_t LZ4_Compress(const uint8_t *source, uint16_t sourceLength, uint8_t *destination, uint16_t destinationCapacity, uint16_t *inPlaceMargin)
+{
+    uint8_t *out = destination;
+    const uint8_t *outEnd = destination + destinationCapacity;
+    uint16_t matchFindEnd = sourceLength > MATCH_FIND_LIMIT ? sourceLength - MATCH_FIND_LIMIT : 0;
+    uint16_t matchEndLimit = sourceLength - LAST_LITERALS;
+    uint16_t anchor = 0;
+    uint16_t position = 0;
+    int32_t maxLead = 0;
+
+    memset(hashTable, 0, sizeof hashTable);
+
+    while (position < matchFindEnd) {
+        uint32_t sequence = readUint32(source + position);
+        uint16_t hash = hashSequence(sequence);
+        uint16_t candidate = hashTable[hash];
+        hashTable[hash] = position;
+
+        if (candidate >= position || position - candidate > LZ4_WINDOW_SIZE || readUint32(source + candidate) != sequence) {
+            position++;
+            continue;
+        }
+
+        uint16_t matchEnd = position + LZ4_MIN_MATCH;
+        while (matchEnd < matchEndLimit && source[matchEnd] == source[candidate + matchEnd - position]) {
+            matchEnd++;
+        }
+
+        out = writeSequence(out, outEnd, source + anchor, position - anchor, matchEnd - position, position - candidate);
+        if (!out) {
+            return 0;
+        }
+
+        // The decoder reads a sequence before writing its output, so the output may only catch up
+        // with the input at sequence boundaries.
+        maxLead = MAX(maxLead, (int32_t)matchEnd - (out - destination));
+        position = matchEnd;
+        anchor = position;
+    }
+
+    out = writeSequence(out, outEnd, source + anchor, sourceLength - anchor, 0, 0);
+    if (!out) {
+        return 0;
+    }
+    maxLead = MAX(maxLead, (int32_t)sourceLength - (out - destination));
+
+    *inPlaceMargin = maxLead;
+    return out - destination;
+}
+
+static bool readExtendedLength(const uint8_t **in, const uint8_t *inEnd, uint32_t *length)
+{
+    uint8_t byte;
+
+    do {
+        if (*in >= inEnd) {
+            return false;
+        }
+        byte = *(*in)++;
+        *length += byte;
+    } while (byte == 255 && *length <= MAX_EXTENDED_LENGTH);
+
+    return *length <= MAX_EXTENDED_LENGTH;
+}
+
+// Copies byte by byte, which keeps in place decompression and overlapping matches correct.
+uint16_t LZ4_Decompress(const uint8_t *source, uint16_t sourceLength, uint8_t *destination, uint16_t destinationCapacity)
+{
+    const uint8_t *in = source;
+    const uint8_t *inEnd = source + sourceLength;
+    uint8_t *out = destination;
+    const uint8_t *outEnd = destination + destinationCapacity;
+
+    while (in < inEnd) {
+        uint8_t token = *in++;
+        uint32_t literalLength = token >> 4;
+
+        if (literalLength == RUN_MASK && !readExtendedLength(&in, inEnd, &literalLength)) {
+            return 0;
+        }
+        if (literalLength > (uint32_t)(inEnd - in) || literalLength > (uint32_t)(outEnd - out)) {
+            return 0;
+        }
+        while (literalLength--) {
+            *out++ = *in++;
+        }
+
+        if (in == inEnd) {
+            break;
+        }
+
+        if (inEnd - in < 2) {
+            return 0;
+        }
+        uint16_t offset = in[0] | in[1] << 8;
+        in += 2;
+
+        uint32_t matchLength = token & RUN_MASK;
+        if (matchLength == RUN_MASK && !readExtendedLength(&in, inEnd, &matchLength)) {
+            return 0;
+        }
+        matchLength += LZ4_MIN_MATCH;
+        if (offset == 0 || offset > out - destination || matchLength > (uint32_t)(outEnd - out)) {
+            return 0;
+        }
+
+        const uint8_t *match = out - offset;
+        while (matchLength--) {
+            *out++ = *match++;
+        }
+    }
+
+    return out - destination;
+}
@@ -0,0 +1,27 @@
+#ifndef __LZ4_H__
+#define __LZ4_H__
+
+// Includes:
+
+    #include <stdint.h>
+
+// Macros:
+
+    #define LZ4_MIN_MATCH 4
+
+    // Matches are only searched this far back, which keeps the hash table small.
+    #define LZ4_WINDOW_SIZE 4096
+    #define LZ4_HASH_BITS 10
+
+// Functions:
+
+    // Compresses into the LZ4 block format. Returns the compressed length, or 0 if it doesn't fit
+    // into the destination. The margin is the distance by which the compressed data has to follow
+    // the start of the decompressed data, so that it can be decompressed in place.
+    uint16_t LZ4_Compress(const uint8_t *source, uint16_t sourceLength, uint8_t *destination, uint16_t destinationCapacity, uint16_t *inPlaceMargin);
+
+    // Returns the decompressed length, or 0 if the data is corrupted or doesn't fit into the
+    // destination.
+    uint16_t LZ4_Decompress(const uint8_t *source, uint16_t sourceLength, uint8_t *destination, uint16_t destinationCapacity);
+
+#endif
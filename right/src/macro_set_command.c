@@ -48,12 +48,23 @@ static void moduleSpeed(const char* arg1, const char *textEnd, module_configurat
 
     if (TokenMatches(arg1, textEnd, "baseSpeed")) {
         module->baseSpeed = ParseFloat(arg2, textEnd);
+        module->accelerationCurve.isValid = false;
     }
     else if (TokenMatches(arg1, textEnd, "speed")) {
         module->speed = ParseFloat(arg2, textEnd);
+        module->accelerationCurve.isValid = false;
     }
     else if (TokenMatches(arg1, textEnd, "xceleration")) {
         module->xceleration = ParseFloat(arg2, textEnd);
+        module->accelerationCurve.isValid = false;
+    }
+    else if (TokenMatches(arg1, textEnd, "smoothingMinCutoff")) {
+        module->smoothingMinCutoff = ParseFloat(arg2, textEnd);
+        module->pointerFilter.isValid = false;
+    }
+    else if (TokenMatches(arg1, textEnd, "smoothingBeta")) {
+        module->smoothingBeta = ParseFloat(arg2, textEnd);
+        module->pointerFilter.isValid = false;
     }
     else if (TokenMatches(arg1, textEnd, "caretSpeedDivisor")) {
         module->caretSpeedDivisor = ParseFloat(arg2, textEnd);
@@ -242,6 +253,14 @@ static void leds(const char* arg1, const char *textEnd)
         LedBrightnessMultiplier = ParseFloat(value, textEnd);
     } else if (TokenMatches(arg1, textEnd, "enabled")) {
         LedsEnabled = Macros_ParseBoolean(value, textEnd);
+    } else if (TokenMatches(arg1, textEnd, "gamma")) {
+        float gamma = ParseFloat(value, textEnd);
+        // Also rejects NaN. Out of range values would light up unlit channels or overflow the tables.
+        if (!(LED_MAP_GAMMA_MIN <= gamma && gamma <= LED_MAP_GAMMA_MAX)) {
+            Macros_ReportErrorFloat("gamma out of the 0.1-4.0 range:", gamma);
+            return;
+        }
+        LedMap_Gamma = gamma;
     } else {
         Macros_ReportError("parameter not recognized:", arg1, textEnd);
     }
@@ -276,6 +295,23 @@ static key_action_t parseKeyAction(const char* arg1, const char *textEnd) {
     else if (TokenMatches(arg1, textEnd, "keystroke")) {
         MacroShortcutParser_Parse(arg2, TokEnd(arg2, textEnd), MacroSubAction_Press, NULL, &action);
     }
+    else if (TokenMatches(arg1, textEnd, "oneShotModifiers")) {
+        key_action_t keystrokeAction;
+        MacroShortcutParser_Parse(arg2, TokEnd(arg2, textEnd), MacroSubAction_Press, NULL, &keystrokeAction);
+
+        if (keystrokeAction.type != KeyActionType_Keystroke || keystrokeAction.keystroke.scancode || !keystrokeAction.keystroke.modifiers) {
+            Macros_ReportError("modifier mask expected:", arg2, textEnd);
+            return action;
+        }
+
+        action.type = KeyActionType_OneShotModifiers;
+        action.oneShotModifiers.modifiers = keystrokeAction.keystroke.modifiers;
+    }
+    else if (TokenMatches(arg1, textEnd, "oneShotLayer")) {
+        action.type = KeyActionType_SwitchLayer;
+        action.switchLayer.layer = Macros_ParseLayerId(arg2, textEnd);
+        action.switchLayer.mode = SwitchLayerMode_OneShot;
+    }
     else if (TokenMatches(arg1, textEnd, "none")) {
         action.type = KeyActionType_None;
     }
@@ -461,6 +497,9 @@ macro_result_t MacroSetCommand(const char* arg1, const char *textEnd)
         DoubleTapSwitchLayerTimeout = delay;
         DoubletapConditionTimeout = delay;
     }
+    else if (TokenMatches(arg1, textEnd, "oneShotTimeout")) {
+        OneShotTimeout = Macros_ParseInt(arg2, textEnd, NULL);
+    }
     else if (TokenMatches(arg1, textEnd, "autoRepeatDelay")) {
         uint16_t delay = Macros_ParseInt(arg2, textEnd, NULL);
         AutoRepeatInitialDelay = delay;
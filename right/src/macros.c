@@ -26,14 +26,23 @@
 #include <string.h>
 #include "usb_commands/usb_command_exec_macro_command.h"
 
-macro_reference_t AllMacros[MacroIndex_MaxCount] = {
+static macro_reference_t macroReferences[MacroIndex_MaxCount] = {
     // 254 is reserved for USB command execution
     // 255 is reserved as empty value
     [MacroIndex_UsbCmdReserved] = {
         .macroActionsCount = 1,
+        .firstActionReference = MACRO_ACTION_REFERENCE_NONE,
     }
 };
+static macro_reference_t ATTR_DATA2 parsedMacroReferences[MacroIndex_MaxCount];
+static macro_action_reference_t macroActionReferences[MAX_MACRO_ACTION_REFERENCE_COUNT];
+static macro_action_reference_t ATTR_DATA2 parsedMacroActionReferences[MAX_MACRO_ACTION_REFERENCE_COUNT];
+
+macro_reference_t *AllMacros = macroReferences;
+macro_reference_t *ParsedMacros = parsedMacroReferences;
 uint8_t AllMacrosCount;
+macro_action_reference_t *MacroActionReferences = macroActionReferences;
+macro_action_reference_t *ParsedMacroActionReferences = parsedMacroActionReferences;
 
 uint8_t MacroBasicScancodeIndex = 0;
 uint8_t MacroMediaScancodeIndex = 0;
@@ -98,6 +107,7 @@ static macro_result_t callMacro(uint8_t macroIndex);
 static macro_result_t forkMacro(uint8_t macroIndex);
 static bool loadNextCommand();
 static bool loadNextAction();
+static bool loadActionByAddress(uint8_t address);
 static void resetToAddressZero(uint8_t macroIndex);
 static uint8_t currentActionCmdCount();
 static macro_result_t sleepTillTime(uint32_t time);
@@ -1533,22 +1543,25 @@ static macro_result_t goToAddress(uint8_t address)
 
     uint8_t oldAddress = s->ms.commandAddress;
 
-    //if we jump back, we have to reset and go from beginning
-    if (address < s->ms.commandAddress) {
-        resetToAddressZero(s->ms.currentMacroIndex);
-    }
+    //if the macro is indexed, load the action that holds the address straight away
+    if (!loadActionByAddress(address)) {
+        //if we jump back, we have to reset and go from beginning
+        if (address < s->ms.commandAddress) {
+            resetToAddressZero(s->ms.currentMacroIndex);
+        }
 
-    //if we are in the middle of multicommand action, parse till the end
-    if(s->ms.commandAddress < address && s->ms.commandAddress != 0) {
-        while (s->ms.commandAddress < address && loadNextCommand());
-    }
+        //if we are in the middle of multicommand action, parse till the end
+        if(s->ms.commandAddress < address && s->ms.commandAddress != 0) {
+            while (s->ms.commandAddress < address && loadNextCommand());
+        }
 
-    //skip across actions without having to read entire action
-    uint8_t cmdCount = currentActionCmdCount();
-    while (s->ms.commandAddress + cmdCount <= address) {
-        loadNextAction();
-        s->ms.commandAddress += cmdCount - 1; //loadNextAction already added one
-        cmdCount = currentActionCmdCount();
+        //skip across actions without having to read entire action
+        uint8_t cmdCount = currentActionCmdCount();
+        while (s->ms.commandAddress + cmdCount <= address) {
+            loadNextAction();
+            s->ms.commandAddress += cmdCount - 1; //loadNextAction already added one
+            cmdCount = currentActionCmdCount();
+        }
     }
 
     //now go command by command
@@ -3099,6 +3112,35 @@ static bool loadNextCommand()
     }
 }
 
+// Looks up the last action that starts at or before the address, which is where the sequential
+// walk would stop as well.
+static bool loadActionByAddress(uint8_t address)
+{
+    const macro_reference_t *macro = &AllMacros[s->ms.currentMacroIndex];
+
+    if (macro->firstActionReference == MACRO_ACTION_REFERENCE_NONE) {
+        return false;
+    }
+
+    const macro_action_reference_t *actions = &MacroActionReferences[macro->firstActionReference];
+    uint8_t low = 0;
+    uint16_t high = macro->macroActionsCount;
+    while (high - low > 1) {
+        uint8_t middle = (low + high) / 2;
+        if (actions[middle].commandAddress <= address) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    s->ms.currentMacroActionIndex = low;
+    s->ms.commandAddress = actions[low].commandAddress;
+    s->ms.bufferOffset = actions[low].offset;
+    loadAction();
+    return true;
+}
+
 static void resetToAddressZero(uint8_t macroIndex)
 {
     s->ms.currentMacroIndex = macroIndex;
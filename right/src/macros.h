@@ -18,6 +18,10 @@
     #define MACRO_STATE_POOL_SIZE 16
     #define MAX_REG_COUNT 32
 
+    // Actions of all macros that fit into the index can be seeked to directly by goTo.
+    #define MAX_MACRO_ACTION_REFERENCE_COUNT 512
+    #define MACRO_ACTION_REFERENCE_NONE 0xFFFF
+
     #define ALTMASK (HID_KEYBOARD_MODIFIER_LEFTALT | HID_KEYBOARD_MODIFIER_RIGHTALT)
     #define CTRLMASK (HID_KEYBOARD_MODIFIER_LEFTCTRL | HID_KEYBOARD_MODIFIER_RIGHTCTRL)
     #define SHIFTMASK (HID_KEYBOARD_MODIFIER_LEFTSHIFT | HID_KEYBOARD_MODIFIER_RIGHTSHIFT)
@@ -37,8 +41,14 @@
         uint16_t firstMacroActionOffset;
         uint8_t macroActionsCount;
         uint8_t macroNameOffset; //negative w.r.t. firstMacroActionOffset
+        uint16_t firstActionReference; //index into MacroActionReferences, or MACRO_ACTION_REFERENCE_NONE
     } macro_reference_t;
 
+    typedef struct {
+        uint16_t offset;
+        uint8_t commandAddress; //address of the first command of the action
+    } macro_action_reference_t;
+
     typedef struct {
         uint8_t layer;
         uint8_t keymap;
@@ -229,8 +239,11 @@
 
 // Variables:
 
-    extern macro_reference_t AllMacros[MacroIndex_MaxCount];
+    extern macro_reference_t *AllMacros;
+    extern macro_reference_t *ParsedMacros;
     extern uint8_t AllMacrosCount;
+    extern macro_action_reference_t *MacroActionReferences;
+    extern macro_action_reference_t *ParsedMacroActionReferences;
     extern macro_state_t MacroState[MACRO_STATE_POOL_SIZE];
     extern bool MacroPlaying;
     extern layer_id_t Macros_ActiveLayer;
@@ -15,23 +15,37 @@
 #include "macro_events.h"
 #include "macro_shortcut_parser.h"
 #include "ledmap.h"
+#include "slave_drivers/is31fl3xxx_driver.h"
 
-static bool IsEepromInitialized = false;
+static volatile bool IsUserConfigRead = false;
+static volatile bool IsHardwareConfigRead = false;
 static bool IsConfigInitialized = false;
+static bool IsHardwareConfigInitialized = false;
 
+static void hardwareConfigurationReadFinished(void)
+{
+    IsHardwareConfigRead = true;
+}
+
+// The user config is read first, so that it can be parsed while the hardware config is being read.
 static void userConfigurationReadFinished(void)
 {
-    IsEepromInitialized = true;
+    IsUserConfigRead = true;
+    EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_HardwareConfig, hardwareConfigurationReadFinished);
 }
 
-static void hardwareConfigurationReadFinished(void)
+static void initHardwareConfig(void)
 {
     InitLedLayout();
     if (IsFactoryResetModeEnabled) {
         HardwareConfig->signatureLength = HARDWARE_CONFIG_SIGNATURE_LENGTH;
         strncpy(HardwareConfig->signature, "FTY", HARDWARE_CONFIG_SIGNATURE_LENGTH);
     }
-    EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_StagingUserConfig, userConfigurationReadFinished);
+
+    // The LED layout depends on the hardware config, so redo the LEDs if the user config came first.
+    if (IsConfigInitialized) {
+        LedSlaveDriver_UpdateLeds();
+    }
 }
 
 int main(void)
@@ -41,7 +55,7 @@ int main(void)
 
     IsFactoryResetModeEnabled = RESET_BUTTON_IS_PRESSED;
 
-    EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_HardwareConfig, hardwareConfigurationReadFinished);
+    EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_StagingUserConfig, userConfigurationReadFinished);
 
     if (IsBusPalOn) {
         init_hardware();
@@ -52,12 +66,16 @@ int main(void)
         InitUsb();
 
         while (1) {
-            if (!IsConfigInitialized && IsEepromInitialized) {
+            if (!IsConfigInitialized && IsUserConfigRead) {
                 UsbCommand_ApplyConfig();
                 ShortcutParser_initialize();
                 Macros_Initialize();
                 IsConfigInitialized = true;
             }
+            if (!IsHardwareConfigInitialized && IsHardwareConfigRead) {
+                initHardwareConfig();
+                IsHardwareConfigInitialized = true;
+            }
             KeyMatrix_ScanRow(&RightKeyMatrix);
             ++MatrixScanCounter;
             UpdateUsbReports();
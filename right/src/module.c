@@ -9,6 +9,8 @@ module_configuration_t ModuleConfigurations[ModuleId_ModuleCount] = {
         .speed = 0.0,
         .baseSpeed = 5.0,
         .xceleration = 0.0,
+        .smoothingMinCutoff = 0.0f, // disabled, opt:1.0
+        .smoothingBeta = 0.0f, // opt:5.0
         .scrollSpeedDivisor = 5.0f,
         .caretSpeedDivisor = 5.0f,
         .pinchZoomSpeedDivisor = 5.0f,
@@ -30,6 +32,8 @@ module_configuration_t ModuleConfigurations[ModuleId_ModuleCount] = {
         .speed = 0.5, // min:0.2, opt:1.0/0.5, max:5
         .baseSpeed = 0.5, // min: 0, opt:0.0/0.5, max 5
         .xceleration = 1.0, // min:0.0, opt:0.5/1.0, max:2.0
+        .smoothingMinCutoff = 0.0f, // disabled, opt:1.0
+        .smoothingBeta = 0.0f, // opt:5.0
         .scrollSpeedDivisor = 8.0f,
         .caretSpeedDivisor = 16.0f,
         .pinchZoomSpeedDivisor = 4.0f,
@@ -51,6 +55,8 @@ module_configuration_t ModuleConfigurations[ModuleId_ModuleCount] = {
         .speed = 1.0, // min:0.2, opt:1.0, max:5
         .baseSpeed = 0.0, // min: 0, opt = 0.0, max 5
         .xceleration = 0.0, // min:0.0, opt:0.0, max:2.0
+        .smoothingMinCutoff = 0.0f, // disabled, opt:1.0
+        .smoothingBeta = 0.0f, // opt:5.0
         .scrollSpeedDivisor = 8.0f,
         .caretSpeedDivisor = 16.0f,
         .pinchZoomSpeedDivisor = 4.0f,
@@ -72,6 +78,8 @@ module_configuration_t ModuleConfigurations[ModuleId_ModuleCount] = {
         .speed = 0.7, // min:0.2, opt:1.3/0.6, max:1.8
         .baseSpeed = 0.5, // min: 0, opt = 0.0/0.5, max 5
         .xceleration = 1.0, // min:0.0, opt:0.5/1.0, max:2.0
+        .smoothingMinCutoff = 0.0f, // disabled, opt:1.0
+        .smoothingBeta = 0.0f, // opt:5.0
         .scrollSpeedDivisor = 8.0f,
         .caretSpeedDivisor = 16.0f,
         .pinchZoomSpeedDivisor = 4.0f,
@@ -93,6 +101,8 @@ module_configuration_t ModuleConfigurations[ModuleId_ModuleCount] = {
         .speed = 1.0, // min:0.2, opt:1.0, max:5
         .baseSpeed = 0.5, // min: 0, opt = 0.0/0.5, max 5
         .xceleration = 5.0, // min:0.1, opt:5.0, max:10.0
+        .smoothingMinCutoff = 0.0f, // disabled, opt:1.0
+        .smoothingBeta = 0.0f, // opt:5.0
         .scrollSpeedDivisor = 8.0f,
         .caretSpeedDivisor = 16.0f,
         .pinchZoomSpeedDivisor = 4.0f,
@@ -6,6 +6,8 @@
     #include "layer.h"
     #include "slot.h"
     #include "slave_protocol.h"
+    #include "acceleration_curve.h"
+    #include "pointer_filter.h"
 
 // Macros:
 
@@ -33,13 +35,20 @@
 
     typedef struct {
         // working 'cache'
-        float currentSpeed; // px/ms
+        uint32_t currentSpeed; // px/ms, ACCELERATION_CURVE_SPEED_FRACTION_BITS fixed point
+        uint16_t lastSampleTime; // ms, in the module's own time base
+        acceleration_curve_t accelerationCurve; // rebuilt whenever isValid is cleared
+        pointer_filter_t pointerFilter; // reconfigured whenever isValid is cleared
 
         // acceleration configurations
         float baseSpeed;
         float speed;
         float xceleration;
 
+        // smoothing configurations
+        float smoothingMinCutoff;
+        float smoothingBeta;
+
         // navigation mode configurations
         float scrollSpeedDivisor;
         float caretSpeedDivisor;
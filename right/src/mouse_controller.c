@@ -23,9 +23,21 @@
 #include "postponer.h"
 #include "layer.h"
 #include "secondary_role_driver.h"
+#include "acceleration_curve.h"
+#include "pointer_filter.h"
+
+// Upper bound of queued caret steps, so that a long swipe doesn't keep scrolling for too long after it ends.
+#define CARET_MAX_PENDING_STEPS 64
+
+// Longer gaps, e.g., after a sleep, are not integrated so that the cursor doesn't jump.
+#define MOUSE_KINETIC_MAX_ELAPSED_TIME_US 50000
 
 static uint32_t mouseUsbReportUpdateTime = 0;
-static uint32_t mouseElapsedTime;
+static uint32_t mouseElapsedTimeUs;
+
+// Wheel units per detent, as negotiated with the host through the resolution multiplier feature.
+static uint8_t horizontalWheelMultiplier = 1;
+static uint8_t verticalWheelMultiplier = 1;
 
 uint8_t ActiveMouseStates[ACTIVE_MOUSE_STATES_COUNT];
 uint8_t ToggledMouseStates[ACTIVE_MOUSE_STATES_COUNT];
@@ -140,13 +152,36 @@ void MouseController_ActivateDirectionSigns(uint8_t state) {
     }
 }
 
+// Advances speed by rate (px/s^2 or px/s) over the elapsed time, in MOUSE_KINETIC_FRACTION_BITS fixed point.
+static int32_t integrateOverElapsedTime(int32_t rate)
+{
+    return ((int64_t)rate * mouseElapsedTimeUs) / 1000000;
+}
+
+// Adds to an 8-bit wheel field of the report, and returns the part that didn't fit.
+static float addToWheel(int8_t *wheel, float amount)
+{
+    float sum = *wheel + amount;
+    float clamped = MAX(MIN(sum, INT8_MAX), -INT8_MAX);
+    *wheel = clamped;
+    return sum - clamped;
+}
+
+// Splits the integer part off the sum, rounding toward zero, and keeps the fractional remainder.
+static int16_t takeIntegerPart(int32_t *sum)
+{
+    int16_t integerPart = *sum / MOUSE_KINETIC_ONE;
+    *sum -= (int32_t)integerPart * MOUSE_KINETIC_ONE;
+    return integerPart;
+}
+
 static void processMouseKineticState(mouse_kinetic_state_t *kineticState)
 {
-    float initialSpeed = kineticState->intMultiplier * kineticState->initialSpeed;
-    float acceleration = kineticState->intMultiplier * kineticState->acceleration;
-    float deceleratedSpeed = kineticState->intMultiplier * kineticState->deceleratedSpeed;
-    float baseSpeed = kineticState->intMultiplier * kineticState->baseSpeed;
-    float acceleratedSpeed = kineticState->intMultiplier * kineticState->acceleratedSpeed;
+    int32_t initialSpeed = kineticState->intMultiplier * kineticState->initialSpeed * MOUSE_KINETIC_ONE;
+    int32_t acceleration = kineticState->intMultiplier * kineticState->acceleration * MOUSE_KINETIC_ONE;
+    int32_t deceleratedSpeed = kineticState->intMultiplier * kineticState->deceleratedSpeed * MOUSE_KINETIC_ONE;
+    int32_t baseSpeed = kineticState->intMultiplier * kineticState->baseSpeed * MOUSE_KINETIC_ONE;
+    int32_t acceleratedSpeed = kineticState->intMultiplier * kineticState->acceleratedSpeed * MOUSE_KINETIC_ONE;
 
     if (!kineticState->wasMoveAction && !ActiveMouseStates[SerializedMouseAction_Decelerate]) {
         kineticState->currentSpeed = initialSpeed;
@@ -179,18 +214,18 @@ static void processMouseKineticState(mouse_kinetic_state_t *kineticState)
 
     if (isMoveAction) {
         if (kineticState->currentSpeed < kineticState->targetSpeed) {
-            kineticState->currentSpeed += acceleration * (float)mouseElapsedTime / 1000.0f;
+            kineticState->currentSpeed += integrateOverElapsedTime(acceleration);
             if (kineticState->currentSpeed > kineticState->targetSpeed) {
                 kineticState->currentSpeed = kineticState->targetSpeed;
             }
         } else {
-            kineticState->currentSpeed -= acceleration * (float)mouseElapsedTime / 1000.0f;
+            kineticState->currentSpeed -= integrateOverElapsedTime(acceleration);
             if (kineticState->currentSpeed < kineticState->targetSpeed) {
                 kineticState->currentSpeed = kineticState->targetSpeed;
             }
         }
 
-        float distance = kineticState->currentSpeed * (float)mouseElapsedTime / 1000.0f;
+        int32_t distance = integrateOverElapsedTime(kineticState->currentSpeed);
 
 
         if (kineticState->isScroll && !kineticState->wasMoveAction) {
@@ -203,24 +238,26 @@ static void processMouseKineticState(mouse_kinetic_state_t *kineticState)
         updateDirectionSigns(kineticState);
 
         if ( kineticState->horizontalStateSign != 0 && kineticState->verticalStateSign != 0 && DiagonalSpeedCompensation ) {
-            distance /= 1.41f;
+            distance = distance * 100 / 141;
         }
 
-        kineticState->xSum += distance * kineticState->horizontalStateSign * kineticState->axisSkew;
-        kineticState->ySum += distance * kineticState->verticalStateSign / kineticState->axisSkew;
+        // Scrolling is accumulated in high-resolution wheel units when the host supports them.
+        int8_t xUnit = kineticState->isScroll ? horizontalWheelMultiplier : 1;
+        int8_t yUnit = kineticState->isScroll ? verticalWheelMultiplier : 1;
+
+        int32_t axisSkew = kineticState->axisSkew * MOUSE_KINETIC_ONE;
+        kineticState->xSum += (((int64_t)distance * axisSkew) >> MOUSE_KINETIC_FRACTION_BITS) * kineticState->horizontalStateSign * xUnit;
+        kineticState->ySum += (((int64_t)distance << MOUSE_KINETIC_FRACTION_BITS) / axisSkew) * kineticState->verticalStateSign * yUnit;
 
         // Update horizontal state
 
         bool horizontalMovement = kineticState->horizontalStateSign != 0;
 
-        float xSumInt;
-        float xSumFrac = modff(kineticState->xSum, &xSumInt);
-        kineticState->xSum = xSumFrac;
-        kineticState->xOut = xSumInt;
+        kineticState->xOut = takeIntegerPart(&kineticState->xSum);
 
         // Handle the first scroll tick.
         if (kineticState->isScroll && !kineticState->wasMoveAction && kineticState->xOut == 0 && horizontalMovement) {
-            kineticState->xOut = ActiveMouseStates[kineticState->leftState] ? -1 : 1;
+            kineticState->xOut = ActiveMouseStates[kineticState->leftState] ? -xUnit : xUnit;
             kineticState->xSum = 0;
         }
 
@@ -228,14 +265,11 @@ static void processMouseKineticState(mouse_kinetic_state_t *kineticState)
 
         bool verticalMovement = kineticState->verticalStateSign != 0;
 
-        float ySumInt;
-        float ySumFrac = modff(kineticState->ySum, &ySumInt);
-        kineticState->ySum = ySumFrac;
-        kineticState->yOut = ySumInt;
+        kineticState->yOut = takeIntegerPart(&kineticState->ySum);
 
         // Handle the first scroll tick.
         if (kineticState->isScroll && !kineticState->wasMoveAction && kineticState->yOut == 0 && verticalMovement) {
-            kineticState->yOut = ActiveMouseStates[kineticState->upState] ? -1 : 1;
+            kineticState->yOut = ActiveMouseStates[kineticState->upState] ? -yUnit : yUnit;
             kineticState->ySum = 0;
         }
     } else {
@@ -246,41 +280,29 @@ static void processMouseKineticState(mouse_kinetic_state_t *kineticState)
     kineticState->wasMoveAction = isMoveAction;
 }
 
-static float fastPow (float a, float b)
-{
-    // https://nic.schraudolph.org/pubs/Schraudolph99.pdf
-    // https://martin.ankerl.com/2007/10/04/optimized-pow-approximation-for-java-and-c-c/
-    if ( b == 0.0f ) {
-        return 1.0f;
-    } else {
-        union {
-            float f;
-            int16_t x[2];
-        } u = { a } ;
-
-        u.x[1] = (int16_t)(b * (u.x[1] - 16249) + 16249);
-        u.x[0] = 0;
-        return u.f;
-    }
-}
-
-static float computeModuleSpeed(float x, float y, uint8_t moduleId)
+// Speed is estimated per module from the timestamps of the samples themselves, so that it
+// doesn't depend on when the delta happened to be transferred and processed.
+static float computeModuleSpeed(float x, float y, uint16_t sampleTime, uint8_t moduleId)
 {
     //means that driver multiplier equals 1.0 at average speed midSpeed px/ms
     static float midSpeed = 3.0f;
     module_configuration_t *moduleConfiguration = GetModuleConfiguration(moduleId);
-    float *currentSpeed = &moduleConfiguration->currentSpeed;
+    acceleration_curve_t *accelerationCurve = &moduleConfiguration->accelerationCurve;
+
+    if (!accelerationCurve->isValid) {
+        AccelerationCurve_Build(accelerationCurve, moduleConfiguration->baseSpeed, moduleConfiguration->speed, moduleConfiguration->xceleration, midSpeed);
+    }
 
     if (x != 0 || y != 0) {
-        static uint32_t lastUpdate = 0;
-        uint32_t elapsedTime = CurrentTime - lastUpdate;
-        float distance = sqrt(x*x + y*y);
-        *currentSpeed = distance / (elapsedTime + 1);
-        lastUpdate = CurrentTime;
+        uint16_t elapsedTime = sampleTime - moduleConfiguration->lastSampleTime;
+        int32_t fixedX = (int32_t)x << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+        int32_t fixedY = (int32_t)y << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+        moduleConfiguration->currentSpeed = AccelerationCurve_Magnitude(fixedX, fixedY) / (elapsedTime + 1);
+        moduleConfiguration->lastSampleTime = sampleTime;
     }
 
-    float normalizedSpeed = *currentSpeed/midSpeed;
-    return moduleConfiguration->baseSpeed + moduleConfiguration->speed*fastPow(normalizedSpeed, moduleConfiguration->xceleration);
+    int32_t multiplier = AccelerationCurve_Evaluate(accelerationCurve, moduleConfiguration->currentSpeed);
+    return (float)multiplier / ACCELERATION_CURVE_MULTIPLIER_ONE;
 }
 
 
@@ -437,7 +459,7 @@ static void progressZoomAction(module_kinetic_state_t* ks) {
     handleSimpleRunningAction(ks);
 }
 
-static void handleNewCaretModeAction(caret_axis_t axis, uint8_t resultSign, int16_t value, module_kinetic_state_t* ks) {
+static void handleNewCaretModeAction(caret_axis_t axis, int8_t resultSign, int16_t value, module_kinetic_state_t* ks) {
     switch(ks->currentNavigationMode) {
         case NavigationMode_Cursor: {
             ActiveUsbMouseReport->x += axis == CaretAxis_Horizontal ? value : 0;
@@ -445,8 +467,9 @@ static void handleNewCaretModeAction(caret_axis_t axis, uint8_t resultSign, int1
             break;
         }
         case NavigationMode_Scroll: {
-            ActiveUsbMouseReport->wheelX += axis == CaretAxis_Horizontal ? value : 0;
-            ActiveUsbMouseReport->wheelY += axis == CaretAxis_Vertical ? value : 0;
+            // Anything beyond the 8-bit range of a single report is dropped.
+            addToWheel(&ActiveUsbMouseReport->wheelX, axis == CaretAxis_Horizontal ? value : 0);
+            addToWheel(&ActiveUsbMouseReport->wheelY, axis == CaretAxis_Vertical ? value : 0);
             break;
         }
         case NavigationMode_ZoomMac:
@@ -515,6 +538,7 @@ static void processAxisLocking(
         if (
                 Timer_GetElapsedTime(&ks->lastUpdate) > 500
                 && ks->caretAxis != CaretAxis_None
+                && ks->pendingSteps == 0
                 && ks->zoomActive == false
                 && ks->caretFakeKeystate.current == false
                 && ks->caretFakeKeystate.previous == false
@@ -546,8 +570,9 @@ static void processAxisLocking(
     ks->xFractionRemainder += x * speed / speedDivisor * caretXModeMultiplier;
     ks->yFractionRemainder += y * speed / speedDivisor * caretYModeMultiplier;
 
-    // Start a new action (new "tick"), unless there is an action in progress.
-    if (!caretModeActionIsRunning(ks)) {
+    // Start a new action (new "tick"), unless there is an action in progress. Discrete
+    // actions are queued instead, so that no steps get lost while an action is running.
+    if (!continuous || !caretModeActionIsRunning(ks)) {
         // determine default axis
         caret_axis_t axisCandidate;
 
@@ -580,16 +605,12 @@ static void processAxisLocking(
 
         // handle the action
         if ( axisCandidate < CaretAxis_Count ) {
-            float sgn = axisIntegerParts[axisCandidate] > 0 ? 1 : -1;
+            int8_t sgn = axisIntegerParts[axisCandidate] > 0 ? 1 : -1;
             int8_t currentAxisInversion = axisCandidate == CaretAxis_Vertical ? yInversion : 1;
-            float consumedAmount = continuous ? axisIntegerParts[axisCandidate] : sgn;
-            *axisFractionRemainders[axisCandidate] -= consumedAmount;
+            int16_t consumedAmount = axisIntegerParts[axisCandidate];
 
-            //always zero primary axis - experimental
-            // TODO: this slows down maximum rate, as right half processing is much faster than module refresh rate.
-            //       We should solve this by zeroing remainder before next event, rather than at the end of previous one.
-            //       In order for this to work, we will have to acknowledge received zeroes.
-            *axisFractionRemainders[axisCandidate] = 0.0f;
+            // keep the fractional part, so that slow movements still add up
+            *axisFractionRemainders[axisCandidate] -= consumedAmount;
 
             if (axisLockEnabled) {
                 // if not axis locking, than allow accumulation of secondary axis
@@ -601,28 +622,43 @@ static void processAxisLocking(
                 *axisFractionRemainders[CaretAxis_Vertical] = 0.0f;
                 *axisFractionRemainders[CaretAxis_Horizontal] = 0.0f;
             }
-            ks->caretAxis = axisCandidate;
 
-            handleNewCaretModeAction(ks->caretAxis, sgn*currentAxisInversion, consumedAmount*currentAxisInversion, ks);
+            if (continuous) {
+                ks->caretAxis = axisCandidate;
+                handleNewCaretModeAction(ks->caretAxis, sgn*currentAxisInversion, consumedAmount*currentAxisInversion, ks);
+            } else {
+                int16_t steps = consumedAmount*currentAxisInversion;
+
+                // changing axis or direction drops whatever was queued for the previous one
+                if (axisCandidate != ks->caretAxis || (steps > 0) != (ks->pendingSteps > 0)) {
+                    ks->pendingSteps = 0;
+                }
+                ks->caretAxis = axisCandidate;
+                ks->pendingSteps = MAX(MIN(ks->pendingSteps + steps, CARET_MAX_PENDING_STEPS), -CARET_MAX_PENDING_STEPS);
+            }
         }
     }
+
+    // Emit queued steps one press/release pair at a time.
+    if (!continuous && ks->pendingSteps != 0 && !caretModeActionIsRunning(ks)) {
+        int8_t sgn = ks->pendingSteps > 0 ? 1 : -1;
+        ks->pendingSteps -= sgn;
+        handleNewCaretModeAction(ks->caretAxis, sgn, sgn, ks);
+    }
 }
 
 static void processModuleKineticState(
         float x,
         float y,
+        float speed,
         module_configuration_t* moduleConfiguration,
         module_kinetic_state_t* ks,
         uint8_t forcedNavigationMode
  ) {
-    float speed;
-
     bool moduleYInversion = ks->currentModuleId == ModuleId_KeyClusterLeft || ks->currentModuleId == ModuleId_TouchpadRight;
     bool scrollYInversion = moduleConfiguration->invertScrollDirection && ks->currentNavigationMode == NavigationMode_Scroll;
     int16_t yInversion = moduleYInversion != scrollYInversion ? -1 : 1;
 
-    speed = computeModuleSpeed(x, y, ks->currentModuleId);
-
     if (ActiveMouseStates[SerializedMouseAction_Accelerate] ) {
         speed *= 2.0f;
     }
@@ -651,13 +687,14 @@ static void processModuleKineticState(
                 float xIntegerPart;
                 float yIntegerPart;
 
-                ks->xFractionRemainder = modff(ks->xFractionRemainder + x * speed / moduleConfiguration->scrollSpeedDivisor, &xIntegerPart);
-                ks->yFractionRemainder = modff(ks->yFractionRemainder + y * speed / moduleConfiguration->scrollSpeedDivisor, &yIntegerPart);
+                ks->xFractionRemainder = modff(ks->xFractionRemainder + x * horizontalWheelMultiplier * speed / moduleConfiguration->scrollSpeedDivisor, &xIntegerPart);
+                ks->yFractionRemainder = modff(ks->yFractionRemainder + y * verticalWheelMultiplier * speed / moduleConfiguration->scrollSpeedDivisor, &yIntegerPart);
 
-                ActiveUsbMouseReport->wheelX += xIntegerPart;
-                ActiveUsbMouseReport->wheelY += yInversion*yIntegerPart;
+                // Keep what doesn't fit into this report for the next one.
+                ks->xFractionRemainder += addToWheel(&ActiveUsbMouseReport->wheelX, xIntegerPart);
+                ks->yFractionRemainder += yInversion*addToWheel(&ActiveUsbMouseReport->wheelY, yInversion*yIntegerPart);
             } else {
-                processAxisLocking(x, y, speed, yInversion, moduleConfiguration->scrollSpeedDivisor, true, moduleConfiguration->axisLockSkew, moduleConfiguration->axisLockFirstTickSkew, ks, true);
+                processAxisLocking(x * horizontalWheelMultiplier, y * verticalWheelMultiplier, speed, yInversion, moduleConfiguration->scrollSpeedDivisor, true, moduleConfiguration->axisLockSkew, moduleConfiguration->axisLockFirstTickSkew, ks, true);
             }
             break;
         }
@@ -686,6 +723,7 @@ static void resetKineticModuleState(module_kinetic_state_t* kineticState)
     kineticState->xFractionRemainder = 0.0f;
     kineticState->yFractionRemainder = 0.0f;
     kineticState->lastUpdate = 0;
+    kineticState->pendingSteps = 0;
 
     //leave caretFakeKeystate & caretAction intact - this will ensure that any ongoing key action will complete properly
 }
@@ -706,10 +744,29 @@ static void processModuleActions(
         uint8_t moduleId,
         float x,
         float y,
+        uint16_t sampleTime,
         uint8_t forcedNavigationMode
 ) {
     module_configuration_t *moduleConfiguration = GetModuleConfiguration(moduleId);
 
+    // Speed is estimated from the raw deltas, smoothing only affects how they are spread over time.
+    float speed = computeModuleSpeed(x, y, sampleTime, moduleId);
+
+    // Touchpad gestures feed the same configuration several times per cycle, only the primary
+    // delta gets smoothed.
+    if (forcedNavigationMode == 0xFF) {
+        pointer_filter_t *pointerFilter = &moduleConfiguration->pointerFilter;
+        int16_t filteredX = x;
+        int16_t filteredY = y;
+
+        if (!pointerFilter->isValid) {
+            PointerFilter_Configure(pointerFilter, moduleConfiguration->smoothingMinCutoff, moduleConfiguration->smoothingBeta);
+        }
+        PointerFilter_Apply(pointerFilter, &filteredX, &filteredY, mouseElapsedTimeUs);
+        x = filteredX;
+        y = filteredY;
+    }
+
     navigation_mode_t navigationMode;
 
     if(forcedNavigationMode == 0xFF) {
@@ -749,12 +806,25 @@ static void processModuleActions(
     //we want to process kinetic state even if x == 0 && y == 0, at least as
     //long as caretAxis != CaretAxis_None because of fake key states that may
     //be active.
-    processModuleKineticState(x, y, moduleConfiguration, ks, forcedNavigationMode);
+    processModuleKineticState(x, y, speed, moduleConfiguration, ks, forcedNavigationMode);
 }
 
 void MouseController_ProcessMouseActions()
 {
-    mouseElapsedTime = Timer_GetElapsedTimeAndSetCurrent(&mouseUsbReportUpdateTime);
+    // Read the time only once, so that no time is lost between consecutive updates.
+    // The clock can step back by up to a millisecond when the PIT wraps before its interrupt has
+    // run. Such reads count as no time, and the previous timestamp is kept.
+    uint32_t currentTimeUs = Timer_GetCurrentTimeMicros();
+    int32_t elapsedTimeUs = currentTimeUs - mouseUsbReportUpdateTime;
+    if (elapsedTimeUs > 0) {
+        mouseElapsedTimeUs = MIN((uint32_t)elapsedTimeUs, MOUSE_KINETIC_MAX_ELAPSED_TIME_US);
+        mouseUsbReportUpdateTime = currentTimeUs;
+    } else {
+        mouseElapsedTimeUs = 0;
+    }
+
+    horizontalWheelMultiplier = UsbMouseGetHorizontalWheelMultiplier();
+    verticalWheelMultiplier = UsbMouseGetVerticalWheelMultiplier();
 
     processMouseKineticState(&MouseMoveState);
     ActiveUsbMouseReport->x = MouseMoveState.xOut;
@@ -770,7 +840,11 @@ void MouseController_ProcessMouseActions()
 
 
     if (Slaves[SlaveId_RightTouchpad].isConnected) {
-        // TODO: this is still unsafe w.r.t interrupts
+        pointer_delta_t movement, wheel, zoom;
+        PointerSeqlock_Take(&TouchpadEvents.movement, &movement);
+        PointerSeqlock_Take(&TouchpadEvents.wheel, &wheel);
+        PointerSeqlock_Take(&TouchpadEvents.zoom, &zoom);
+
         processTouchpadActions();
 
         module_kinetic_state_t *ks = getKineticState(ModuleId_TouchpadRight);
@@ -779,14 +853,9 @@ void MouseController_ProcessMouseActions()
             handleRunningCaretModeAction(ks);
         }
 
-        processModuleActions(ks, ModuleId_TouchpadRight, (int16_t)TouchpadEvents.x, (int16_t)TouchpadEvents.y, 0xFF);
-        processModuleActions(ks, ModuleId_TouchpadRight, (int16_t)TouchpadEvents.wheelX, (int16_t)TouchpadEvents.wheelY, NavigationMode_Scroll);
-        processModuleActions(ks, ModuleId_TouchpadRight, 0, (int16_t)TouchpadEvents.zoomLevel, NavigationMode_Zoom);
-        TouchpadEvents.zoomLevel = 0;
-        TouchpadEvents.wheelX = 0;
-        TouchpadEvents.wheelY = 0;
-        TouchpadEvents.x = 0;
-        TouchpadEvents.y = 0;
+        processModuleActions(ks, ModuleId_TouchpadRight, movement.x, movement.y, movement.sampleTime, 0xFF);
+        processModuleActions(ks, ModuleId_TouchpadRight, wheel.x, wheel.y, wheel.sampleTime, NavigationMode_Scroll);
+        processModuleActions(ks, ModuleId_TouchpadRight, 0, zoom.y, zoom.sampleTime, NavigationMode_Zoom);
     }
 
     for (uint8_t moduleSlotId=0; moduleSlotId<UHK_MODULE_MAX_SLOT_COUNT; moduleSlotId++) {
@@ -795,15 +864,9 @@ void MouseController_ProcessMouseActions()
             continue;
         }
 
-        __disable_irq();
-        // Gcc compiles those int16_t assignments as sequences of
-        // single-byte instructions, therefore we need to make the
-        // sequence atomic.
-        int16_t x = moduleState->pointerDelta.x;
-        int16_t y = moduleState->pointerDelta.y;
-        moduleState->pointerDelta.x = 0;
-        moduleState->pointerDelta.y = 0;
-        __enable_irq();
+        // A delta that is being written right now is taken in the next cycle.
+        pointer_delta_t delta;
+        PointerSeqlock_Take(&moduleState->pointerDelta, &delta);
 
         module_kinetic_state_t *ks = getKineticState(moduleState->moduleId);
 
@@ -811,7 +874,7 @@ void MouseController_ProcessMouseActions()
             handleRunningCaretModeAction(ks);
         }
 
-        processModuleActions(ks, moduleState->moduleId, x, y, 0xFF);
+        processModuleActions(ks, moduleState->moduleId, delta.x, delta.y, delta.sampleTime, 0xFF);
     }
 
     if (ActiveMouseStates[SerializedMouseAction_LeftClick]) {
@@ -11,6 +11,10 @@
     #define ACTIVE_MOUSE_STATES_COUNT (SerializedMouseAction_Last + 1)
     #define ABS(A) ((A) < 0 ? (-A) : (A))
 
+    // Mouse key speeds (px/s) and travelled distances (px) are kept with 16 fractional bits.
+    #define MOUSE_KINETIC_FRACTION_BITS 16
+    #define MOUSE_KINETIC_ONE (1 << MOUSE_KINETIC_FRACTION_BITS)
+
 // Typedefs:
 
     typedef enum {
@@ -27,17 +31,17 @@
         serialized_mouse_action_t leftState;
         serialized_mouse_action_t rightState;
         mouse_speed_t prevMouseSpeed;
-        float intMultiplier;
-        float currentSpeed;
-        float targetSpeed;
+        uint8_t intMultiplier;
+        int32_t currentSpeed;
+        int32_t targetSpeed;
         float axisSkew;
         uint8_t initialSpeed;
         uint8_t acceleration;
         uint8_t deceleratedSpeed;
         uint8_t baseSpeed;
         uint8_t acceleratedSpeed;
-        float xSum;
-        float ySum;
+        int32_t xSum;
+        int32_t ySum;
         int16_t xOut;
         int16_t yOut;
         int8_t verticalStateSign;
@@ -55,7 +59,8 @@
         uint8_t currentModuleId;
         uint8_t currentNavigationMode;
         uint8_t zoomPhase;
-        uint8_t zoomSign;
+        int8_t zoomSign;
+        int16_t pendingSteps;
         bool zoomActive;
     } module_kinetic_state_t;
 
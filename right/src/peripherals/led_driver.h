@@ -23,6 +23,7 @@
 
     #define LED_DRIVER_REGISTER_CONFIGURATION 0x00
     #define LED_DRIVER_REGISTER_GLOBAL_CURRENT 0x01
+    #define LED_DRIVER_REGISTER_PICTURE_DISPLAY 0x01
     #define LED_DRIVER_REGISTER_SHUTDOWN 0x0A
     #define LED_DRIVER_REGISTER_FRAME 0xFD
     #define LED_DRIVER_REGISTER_WRITE_LOCK 0xFE
@@ -17,4 +17,8 @@
     #define PIT_TIMER_IRQ_ID          PIT1_IRQn
     #define PIT_TIMER_CHANNEL         kPIT_Chnl_1
 
+    #define PIT_EEPROM_HANDLER        PIT2_IRQHandler
+    #define PIT_EEPROM_IRQ_ID         PIT2_IRQn
+    #define PIT_EEPROM_CHANNEL        kPIT_Chnl_2
+
 #endif
@@ -0,0 +1,109 @@
+#include "pointer_filter.h"
+#include "acceleration_curve.h"
+
+// 1000000 / (2*pi) with POINTER_FILTER_FRACTION_BITS, so that dividing it by a fixed-point cutoff
+// frequency yields the time constant in microseconds.
+#define TAU_NUMERATOR 40743665
+
+// Keeps the speed computation within 32 bits, corresponds to 16384 px.
+#define MAX_DISTANCE (1 << 22)
+
+static uint32_t toFixedPoint(float value)
+{
+    float scaledValue = value * POINTER_FILTER_ONE;
+
+    if (scaledValue <= 0.0f) {
+        return 0;
+    } else if (scaledValue >= (float)UINT32_MAX) {
+        return UINT32_MAX;
+    }
+    return (uint32_t)scaledValue;
+}
+
+// alpha = Te / (Te + tau), where tau = 1 / (2*pi*cutoff)
+static uint32_t computeAlpha(uint32_t cutoff, uint32_t elapsedTimeUs)
+{
+    uint32_t tau = TAU_NUMERATOR / cutoff;
+    return (elapsedTimeUs << POINTER_FILTER_ALPHA_FRACTION_BITS) / (elapsedTimeUs + tau);
+}
+
+static uint32_t computeSpeed(int16_t x, int16_t y, uint32_t elapsedTimeUs)
+{
+    uint32_t distance = AccelerationCurve_Magnitude((int32_t)x * POINTER_FILTER_ONE, (int32_t)y * POINTER_FILTER_ONE);
+
+    if (distance > MAX_DISTANCE) {
+        distance = MAX_DISTANCE;
+    }
+    return distance * 1000 / elapsedTimeUs;
+}
+
+// Scales the lag symmetrically, and always releases at least the smallest unit, so that a
+// low cutoff can't leave a residue behind.
+static int32_t releaseLag(int32_t *lag, uint32_t alpha)
+{
+    int32_t magnitude = *lag < 0 ? -*lag : *lag;
+    int32_t release = ((int64_t)magnitude * alpha) >> POINTER_FILTER_ALPHA_FRACTION_BITS;
+
+    if (release == 0 && magnitude != 0) {
+        release = 1;
+    }
+    if (*lag < 0) {
+        release = -release;
+    }
+    *lag -= release;
+    return release;
+}
+
+// Emits whole pixels, rounded towards zero, and keeps the rest for the next step.
+static int16_t takeWholePixels(int32_t *remainder, int32_t release)
+{
+    *remainder += release;
+    int32_t pixels = *remainder / POINTER_FILTER_ONE;
+
+    if (pixels > INT16_MAX) {
+        pixels = INT16_MAX;
+    } else if (pixels < INT16_MIN) {
+        pixels = INT16_MIN;
+    }
+    *remainder -= pixels * POINTER_FILTER_ONE;
+    return pixels;
+}
+
+void PointerFilter_Configure(pointer_filter_t *filter, float minCutoff, float beta)
+{
+    filter->minCutoff = toFixedPoint(minCutoff);
+    filter->beta = toFixedPoint(beta);
+    filter->isValid = true;
+}
+
+// The cutoff rises with the filtered speed, so that slow movements get smoothed and fast ones
+// don't lag. Costs a few divisions per step regardless of the settings. A disabled filter just
+// flushes whatever lag it still holds.
+void PointerFilter_Apply(pointer_filter_t *filter, int16_t *x, int16_t *y, uint32_t elapsedTimeUs)
+{
+    uint32_t alpha = POINTER_FILTER_ALPHA_ONE;
+
+    if (elapsedTimeUs > POINTER_FILTER_MAX_ELAPSED_TIME_US) {
+        elapsedTimeUs = POINTER_FILTER_MAX_ELAPSED_TIME_US;
+    }
+
+    filter->lagX += (int32_t)*x * POINTER_FILTER_ONE;
+    filter->lagY += (int32_t)*y * POINTER_FILTER_ONE;
+
+    if (filter->minCutoff != 0) {
+        if (elapsedTimeUs == 0) {
+            alpha = 0;
+        } else {
+            uint32_t rawSpeed = computeSpeed(*x, *y, elapsedTimeUs);
+            uint32_t speedAlpha = computeAlpha(POINTER_FILTER_SPEED_CUTOFF * POINTER_FILTER_ONE, elapsedTimeUs);
+            int64_t speedDifference = (int64_t)rawSpeed - filter->speed;
+            filter->speed += (speedDifference * speedAlpha) >> POINTER_FILTER_ALPHA_FRACTION_BITS;
+
+            uint64_t cutoff = filter->minCutoff + (((uint64_t)filter->beta * filter->speed) >> POINTER_FILTER_FRACTION_BITS);
+            alpha = computeAlpha(cutoff > UINT32_MAX ? UINT32_MAX : cutoff, elapsedTimeUs);
+        }
+    }
+
+    *x = takeWholePixels(&filter->remainderX, releaseLag(&filter->lagX, alpha));
+    *y = takeWholePixels(&filter->remainderY, releaseLag(&filter->lagY, alpha));
+}
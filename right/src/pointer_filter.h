@@ -0,0 +1,48 @@
+#ifndef __POINTER_FILTER_H__
+#define __POINTER_FILTER_H__
+
+// Includes:
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+// Macros:
+
+    // Positions are in px with 8 fractional bits, speeds in px/ms with 8 fractional bits.
+    #define POINTER_FILTER_FRACTION_BITS 8
+    #define POINTER_FILTER_ONE (1 << POINTER_FILTER_FRACTION_BITS)
+
+    // Smoothing factors are unitless with 16 fractional bits.
+    #define POINTER_FILTER_ALPHA_FRACTION_BITS 16
+    #define POINTER_FILTER_ALPHA_ONE (1 << POINTER_FILTER_ALPHA_FRACTION_BITS)
+
+    // Cutoff of the speed estimate that drives the adaptive cutoff, in Hz.
+    #define POINTER_FILTER_SPEED_CUTOFF 1
+
+    // Longer steps are clamped, which also keeps the fixed-point arithmetic within 32 bits.
+    #define POINTER_FILTER_MAX_ELAPSED_TIME_US 50000
+
+// Typedefs:
+
+    // One euro filter on relative deltas. Instead of a filtered position, it keeps the lag behind
+    // the raw position, and releases a part of it every step, so no movement is ever lost.
+    typedef struct {
+        // configuration, derived from the float settings whenever isValid is cleared
+        uint32_t minCutoff; // Hz, POINTER_FILTER_FRACTION_BITS fixed point, 0 disables the filter
+        uint32_t beta; // Hz per px/ms, POINTER_FILTER_FRACTION_BITS fixed point
+        bool isValid;
+
+        // state
+        int32_t lagX;
+        int32_t lagY;
+        int32_t remainderX;
+        int32_t remainderY;
+        uint32_t speed;
+    } pointer_filter_t;
+
+// Functions:
+
+    void PointerFilter_Configure(pointer_filter_t *filter, float minCutoff, float beta);
+    void PointerFilter_Apply(pointer_filter_t *filter, int16_t *x, int16_t *y, uint32_t elapsedTimeUs);
+
+#endif
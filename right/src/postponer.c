@@ -288,6 +288,7 @@ static uint8_t priority(key_state_t *key, bool active)
         case KeyActionType_SwitchKeymap:
             return 2;
         case KeyActionType_PlayMacro:
+        case KeyActionType_OneShotModifiers:
             return 1;
     }
     return 0;
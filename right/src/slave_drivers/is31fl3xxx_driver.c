@@ -4,6 +4,7 @@
 #include "led_display.h"
 #include "device.h"
 #include "ledmap.h"
+#include "timer.h"
 
 
 bool LedsEnabled = true;
@@ -13,6 +14,14 @@ float LedBrightnessMultiplier = 1.0f;
 uint8_t KeyBacklightBrightness = 0xff;
 uint8_t KeyBacklightBrightnessDefault = 0xff;
 uint8_t LedDriverValues[LED_DRIVER_MAX_COUNT][LED_DRIVER_LED_COUNT_MAX];
+uint32_t LedDriverDirtyMasks[LED_DRIVER_MAX_COUNT][LED_DRIVER_DIRTY_MASK_WORD_COUNT];
+
+uint32_t LedSlaveDriver_FrameCounter;
+uint32_t LedSlaveDriver_FrameTimeUs;
+uint32_t LedSlaveDriver_MaxFrameTimeUs;
+
+static volatile uint8_t openFrameCount;
+static uint32_t frameCommitTime;
 
 #if DEVICE_ID == DEVICE_ID_UHK60V1
 static uint8_t setShutdownModeNormalBufferIS31FL3731[] = {LED_DRIVER_REGISTER_SHUTDOWN, SHUTDOWN_MODE_NORMAL};
@@ -176,6 +185,8 @@ static uint8_t setGlobalCurrentBuffer[] = {LED_DRIVER_REGISTER_GLOBAL_CURRENT, 0
 static uint8_t setFrame1Buffer[] = {LED_DRIVER_REGISTER_FRAME, LED_DRIVER_FRAME_1};
 static uint8_t setFrame2Buffer[] = {LED_DRIVER_REGISTER_FRAME, LED_DRIVER_FRAME_2};
 static uint8_t setFrame4Buffer[] = {LED_DRIVER_REGISTER_FRAME, LED_DRIVER_FRAME_4};
+static uint8_t setBackFrameBuffer[] = {LED_DRIVER_REGISTER_FRAME, LED_DRIVER_FRAME_2};
+static uint8_t showBackFrameBuffer[] = {LED_DRIVER_REGISTER_PICTURE_DISPLAY, LED_DRIVER_FRAME_2};
 static uint8_t updateDataBuffer[] = {0x10, 0x00};
 static uint8_t setLedBrightness[] = {0x04, 0b00110000};
 static uint8_t updatePwmRegistersBuffer[PWM_REGISTER_BUFFER_LENGTH];
@@ -192,26 +203,119 @@ static void recalculateLedBrightness() {
     }
 }
 
-void LedSlaveDriver_DisableLeds(void)
+static void setAllLedValues(uint8_t value)
+{
+    for (uint8_t ledDriverId=0; ledDriverId<=LedDriverId_Last; ledDriverId++) {
+        for (uint8_t ledIndex=0; ledIndex<ledDriverStates[ledDriverId].ledCount; ledIndex++) {
+            LedSlaveDriver_SetLedValue(ledDriverId, ledIndex, value);
+        }
+    }
+}
+
+// Finds the first dirty LED, and the last one that still fits into the same write, so that
+// adjacent dirty runs are coalesced into a single auto-increment burst. Clean LEDs in between
+// are resent, which is cheaper than another transaction.
+static bool findDirtyLedRange(const uint32_t *dirtyMask, uint8_t ledCount, uint8_t *startLedIndex, uint8_t *endLedIndex)
+{
+    uint8_t wordCount = (ledCount + LED_DRIVER_DIRTY_MASK_WORD_BITS - 1) / LED_DRIVER_DIRTY_MASK_WORD_BITS;
+    uint8_t wordIndex = 0;
+
+    while (wordIndex < wordCount && dirtyMask[wordIndex] == 0) {
+        wordIndex++;
+    }
+    if (wordIndex == wordCount) {
+        return false;
+    }
+    *startLedIndex = wordIndex * LED_DRIVER_DIRTY_MASK_WORD_BITS + __builtin_ctz(dirtyMask[wordIndex]);
+
+    uint8_t maxEndLedIndex = *startLedIndex + MIN(ledCount - *startLedIndex, PMW_REGISTER_UPDATE_CHUNK_SIZE) - 1;
+    wordIndex = maxEndLedIndex / LED_DRIVER_DIRTY_MASK_WORD_BITS;
+    uint32_t word = dirtyMask[wordIndex];
+    uint8_t maxEndBit = maxEndLedIndex % LED_DRIVER_DIRTY_MASK_WORD_BITS;
+    if (maxEndBit != LED_DRIVER_DIRTY_MASK_WORD_BITS - 1) {
+        word &= (1UL << (maxEndBit + 1)) - 1;
+    }
+
+    while (word == 0) {
+        word = dirtyMask[--wordIndex];
+    }
+    *endLedIndex = wordIndex * LED_DRIVER_DIRTY_MASK_WORD_BITS + (LED_DRIVER_DIRTY_MASK_WORD_BITS - 1 - __builtin_clz(word));
+    return true;
+}
+
+static bool isAnyLedDirty(const uint32_t *dirtyMask)
+{
+    for (uint8_t wordIndex=0; wordIndex<LED_DRIVER_DIRTY_MASK_WORD_COUNT; wordIndex++) {
+        if (dirtyMask[wordIndex]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void finishFrame(led_driver_state_t *ledDriverState)
+{
+    if (!ledDriverState->isFrameInFlight) {
+        return;
+    }
+    ledDriverState->isFrameInFlight = false;
+    LedSlaveDriver_FrameTimeUs = Timer_GetElapsedTimeMicros(&frameCommitTime);
+    LedSlaveDriver_MaxFrameTimeUs = MAX(LedSlaveDriver_MaxFrameTimeUs, LedSlaveDriver_FrameTimeUs);
+}
+
+static void clearDirtyLedRange(uint32_t *dirtyMask, uint8_t startLedIndex, uint8_t endLedIndex)
+{
+    for (uint16_t ledIndex=startLedIndex; ledIndex<=endLedIndex; ledIndex++) {
+        dirtyMask[ledIndex / LED_DRIVER_DIRTY_MASK_WORD_BITS] &= ~(1UL << (ledIndex % LED_DRIVER_DIRTY_MASK_WORD_BITS));
+    }
+}
+
+void LedSlaveDriver_BeginFrame(void)
 {
+    openFrameCount++;
+}
+
+// Frame times are measured from here until every driver has sent its part. Frames that don't
+// change anything aren't counted.
+void LedSlaveDriver_EndFrame(void)
+{
+    if (--openFrameCount) {
+        return;
+    }
+
+    bool hasChanges = false;
+    frameCommitTime = Timer_GetCurrentTimeMicros();
     for (uint8_t ledDriverId=0; ledDriverId<=LedDriverId_Last; ledDriverId++) {
-        memset(LedDriverValues[ledDriverId], 0, ledDriverStates[ledDriverId].ledCount);
+        if (isAnyLedDirty(LedDriverDirtyMasks[ledDriverId])) {
+            ledDriverStates[ledDriverId].isFrameInFlight = true;
+            hasChanges = true;
+        }
+    }
+    if (hasChanges) {
+        LedSlaveDriver_FrameCounter++;
     }
 }
 
+void LedSlaveDriver_DisableLeds(void)
+{
+    LedSlaveDriver_BeginFrame();
+    setAllLedValues(0);
+    LedSlaveDriver_EndFrame();
+}
+
 void LedSlaveDriver_UpdateLeds(void)
 {
+    LedSlaveDriver_BeginFrame();
     recalculateLedBrightness();
 
 #if DEVICE_ID == DEVICE_ID_UHK60V1
-    for (uint8_t ledDriverId=0; ledDriverId<=LedDriverId_Last; ledDriverId++) {
-        memset(LedDriverValues[ledDriverId], KeyBacklightBrightness, ledDriverStates[ledDriverId].ledCount);
-    }
+    setAllLedValues(KeyBacklightBrightness);
 #else
     UpdateLayerLeds();
 #endif
 
     LedDisplay_UpdateAll();
+    LedSlaveDriver_EndFrame();
 }
 
 void LedSlaveDriver_Init(uint8_t ledDriverId)
@@ -233,6 +337,10 @@ void LedSlaveDriver_Init(uint8_t ledDriverId)
             break;
     }
     currentLedDriverState->ledIndex = 0;
+    currentLedDriverState->backFrame = LED_DRIVER_FRAME_2;
+    currentLedDriverState->isBackFrameInitialized = false;
+    memset(currentLedDriverState->backFrameDirtyMask, 0xff, sizeof(currentLedDriverState->backFrameDirtyMask));
+    currentLedDriverState->isFrameInFlight = false;
 }
 
 slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId)
@@ -245,6 +353,8 @@ slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId)
     uint8_t ledCount = currentLedDriverState->ledCount;
     uint8_t frameRegisterPwmFirst = currentLedDriverState->frameRegisterPwmFirst;
     uint8_t *ledIndex = &currentLedDriverState->ledIndex;
+    uint32_t *dirtyMask = LedDriverDirtyMasks[ledDriverId];
+    uint32_t *backFrameDirtyMask = currentLedDriverState->backFrameDirtyMask;
 
     switch (*ledDriverPhase) {
         case LedDriverPhase_UnlockCommandRegister1:
@@ -303,14 +413,17 @@ slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId)
             *ledDriverPhase = LedDriverPhase_InitLedValues;
             break;
         case LedDriverPhase_InitLedValues:
+            // Values that change after their chunk has been sent get marked dirty again.
+            if (*ledIndex == 0) {
+                memset(dirtyMask, 0, sizeof(LedDriverDirtyMasks[ledDriverId]));
+            }
             updatePwmRegistersBuffer[0] = frameRegisterPwmFirst + *ledIndex;
             uint8_t chunkSize = MIN(ledCount - *ledIndex, PMW_REGISTER_UPDATE_CHUNK_SIZE);
             memcpy(updatePwmRegistersBuffer+1, ledValues + *ledIndex, chunkSize);
-            res.status = I2cAsyncWrite(ledDriverAddress, updatePwmRegistersBuffer, chunkSize + 1);
+            res.status = I2cAsyncWriteDma(ledDriverAddress, updatePwmRegistersBuffer, chunkSize + 1);
             *ledIndex += chunkSize;
             if (*ledIndex >= ledCount) {
                 *ledIndex = 0;
-                memcpy(currentLedDriverState->targetLedValues, ledValues, ledCount);
                 *ledDriverPhase = currentLedDriverState->ledDriverIc == LedDriverIc_IS31FL3199
                     ? LedDriverPhase_SetLedBrightness
                     : LedDriverPhase_UpdateChangedLedValues;
@@ -321,46 +434,41 @@ slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId)
             *ledDriverPhase = LedDriverPhase_UpdateChangedLedValues;
             break;
         case LedDriverPhase_UpdateChangedLedValues: {
-            uint8_t *targetLedValues = currentLedDriverState->targetLedValues;
+            uint8_t startLedIndex;
+            uint8_t endLedIndex;
 
-            uint8_t lastLedChunkStartIndex = ledCount - PMW_REGISTER_UPDATE_CHUNK_SIZE;
-            uint8_t startLedIndex = *ledIndex > lastLedChunkStartIndex ? lastLedChunkStartIndex : *ledIndex;
+            // Half-written frames are held back, so they can't tear.
+            if (openFrameCount) {
+                break;
+            }
 
-            uint8_t count;
-            for (count=0; count<ledCount; count++) {
-                if (ledValues[startLedIndex] != targetLedValues[startLedIndex]) {
+            // The IS31FL3731 gets the whole frame written while it's hidden. The first flip after
+            // the init also sets up the second frame, and brings the displayed frame in sync.
+            if (currentLedDriverState->ledDriverIc == LedDriverIc_IS31FL3731) {
+                if (!isAnyLedDirty(dirtyMask) && currentLedDriverState->isBackFrameInitialized) {
+                    finishFrame(currentLedDriverState);
                     break;
                 }
-
-                if (++startLedIndex >= ledCount) {
-                    startLedIndex = 0;
-                }
-            }
-
-            bool foundStartIndex = count < ledCount;
-            if (!foundStartIndex && currentLedDriverState->ledDriverIc != LedDriverIc_IS31FL3199) {
-                *ledIndex = 0;
+                setBackFrameBuffer[1] = currentLedDriverState->backFrame;
+                res.status = I2cAsyncWrite(ledDriverAddress, setBackFrameBuffer, sizeof(setBackFrameBuffer));
+                *ledDriverPhase = currentLedDriverState->isBackFrameInitialized
+                    ? LedDriverPhase_UpdateBackFrameLedValues
+                    : LedDriverPhase_InitBackFrameLedControlRegisters;
                 break;
             }
 
-            uint8_t maxChunkSize = MIN(ledCount - startLedIndex, PMW_REGISTER_UPDATE_CHUNK_SIZE);
-            uint8_t maxEndLedIndex = startLedIndex + maxChunkSize - 1;
-            uint8_t endLedIndex = startLedIndex;
-            for (uint8_t index=startLedIndex; index<=maxEndLedIndex; index++) {
-                if (ledValues[index] != targetLedValues[index]) {
-                    endLedIndex = index;
-                }
+            // The scheduler runs in the I2C interrupt, so a value can't change between the copy and
+            // the clearing below. A bit that gets set again meanwhile only causes a redundant write.
+            if (!findDirtyLedRange(dirtyMask, ledCount, &startLedIndex, &endLedIndex)) {
+                finishFrame(currentLedDriverState);
+                break;
             }
 
             updatePwmRegistersBuffer[0] = frameRegisterPwmFirst + startLedIndex;
             uint8_t length = endLedIndex - startLedIndex + 1;
             memcpy(updatePwmRegistersBuffer+1, ledValues + startLedIndex, length);
-            memcpy(currentLedDriverState->targetLedValues + startLedIndex, ledValues + startLedIndex, length);
-            res.status = I2cAsyncWrite(ledDriverAddress, updatePwmRegistersBuffer, length+1);
-            *ledIndex += length;
-            if (*ledIndex >= ledCount) {
-                *ledIndex = 0;
-            }
+            clearDirtyLedRange(dirtyMask, startLedIndex, endLedIndex);
+            res.status = I2cAsyncWriteDma(ledDriverAddress, updatePwmRegistersBuffer, length+1);
 
             if (currentLedDriverState->ledDriverIc == LedDriverIc_IS31FL3199) {
                 *ledDriverPhase = LedDriverPhase_UpdateData;
@@ -371,6 +479,48 @@ slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId)
             res.status = I2cAsyncWrite(ledDriverAddress, updateDataBuffer, sizeof(updateDataBuffer));
             *ledDriverPhase = LedDriverPhase_UpdateChangedLedValues;
             break;
+        case LedDriverPhase_InitBackFrameLedControlRegisters:
+            res.status = I2cAsyncWrite(ledDriverAddress, currentLedDriverState->setupLedControlRegistersCommand, currentLedDriverState->setupLedControlRegistersCommandLength);
+            currentLedDriverState->isBackFrameInitialized = true;
+            *ledDriverPhase = LedDriverPhase_UpdateBackFrameLedValues;
+            break;
+        case LedDriverPhase_UpdateBackFrameLedValues: {
+            uint32_t staleMask[LED_DRIVER_DIRTY_MASK_WORD_COUNT];
+            uint8_t startLedIndex;
+            uint8_t endLedIndex;
+
+            if (openFrameCount) {
+                break;
+            }
+
+            // The back frame still holds the frame before the displayed one, so it also misses
+            // the values that changed with the previous flip.
+            for (uint8_t wordIndex=0; wordIndex<LED_DRIVER_DIRTY_MASK_WORD_COUNT; wordIndex++) {
+                staleMask[wordIndex] = dirtyMask[wordIndex] | backFrameDirtyMask[wordIndex];
+            }
+            if (findDirtyLedRange(staleMask, ledCount, &startLedIndex, &endLedIndex)) {
+                updatePwmRegistersBuffer[0] = frameRegisterPwmFirst + startLedIndex;
+                uint8_t length = endLedIndex - startLedIndex + 1;
+                memcpy(updatePwmRegistersBuffer+1, ledValues + startLedIndex, length);
+                memcpy(backFrameDirtyMask, dirtyMask, sizeof(currentLedDriverState->backFrameDirtyMask));
+                clearDirtyLedRange(dirtyMask, startLedIndex, endLedIndex);
+                res.status = I2cAsyncWriteDma(ledDriverAddress, updatePwmRegistersBuffer, length+1);
+            }
+            *ledDriverPhase = LedDriverPhase_SetFunctionFrameForFlip;
+            break;
+        }
+        case LedDriverPhase_SetFunctionFrameForFlip:
+            res.status = I2cAsyncWrite(ledDriverAddress, setFunctionFrameBuffer, sizeof(setFunctionFrameBuffer));
+            *ledDriverPhase = LedDriverPhase_ShowBackFrame;
+            break;
+        case LedDriverPhase_ShowBackFrame:
+            showBackFrameBuffer[1] = currentLedDriverState->backFrame;
+            res.status = I2cAsyncWrite(ledDriverAddress, showBackFrameBuffer, sizeof(showBackFrameBuffer));
+            currentLedDriverState->backFrame = currentLedDriverState->backFrame == LED_DRIVER_FRAME_1
+                ? LED_DRIVER_FRAME_2
+                : LED_DRIVER_FRAME_1;
+            *ledDriverPhase = LedDriverPhase_UpdateChangedLedValues;
+            break;
     }
 
     return res;
@@ -18,6 +18,9 @@
     #define PMW_REGISTER_UPDATE_CHUNK_SIZE LED_DRIVER_LED_COUNT_IS31FL3737
     #define PWM_REGISTER_BUFFER_LENGTH (1 + PMW_REGISTER_UPDATE_CHUNK_SIZE)
 
+    #define LED_DRIVER_DIRTY_MASK_WORD_BITS 32
+    #define LED_DRIVER_DIRTY_MASK_WORD_COUNT ((LED_DRIVER_LED_COUNT_MAX + LED_DRIVER_DIRTY_MASK_WORD_BITS - 1) / LED_DRIVER_DIRTY_MASK_WORD_BITS)
+
     #define IS_ISO true
     #define ISO_KEY_LED_DRIVER_ID LedDriverId_Left
     #define ISO_KEY_CONTROL_REGISTER_POS 7
@@ -52,12 +55,15 @@
         LedDriverPhase_UpdateData,
         LedDriverPhase_SetLedBrightness,
         LedDriverPhase_UpdateChangedLedValues,
+        LedDriverPhase_InitBackFrameLedControlRegisters,
+        LedDriverPhase_UpdateBackFrameLedValues,
+        LedDriverPhase_SetFunctionFrameForFlip,
+        LedDriverPhase_ShowBackFrame,
     } led_driver_phase_t;
 
     typedef struct {
         led_driver_phase_t phase;
         uint8_t ledCount;
-        uint8_t targetLedValues[LED_DRIVER_LED_COUNT_MAX];
         uint8_t ledIndex;
         uint8_t i2cAddress;
         led_driver_ic_t ledDriverIc;
@@ -66,6 +72,13 @@
         uint8_t *setShutdownModeNormalBuffer;
         uint8_t setupLedControlRegistersCommandLength;
         uint8_t setupLedControlRegistersCommand[LED_CONTROL_REGISTERS_COMMAND_LENGTH_MAX];
+
+        // IS31FL3731 only: frames are written while hidden, and shown once complete.
+        uint8_t backFrame;
+        bool isBackFrameInitialized;
+        uint32_t backFrameDirtyMask[LED_DRIVER_DIRTY_MASK_WORD_COUNT];
+
+        bool isFrameInFlight;
     } led_driver_state_t;
 
 // Variables:
@@ -76,6 +89,10 @@
     extern uint8_t KeyBacklightBrightness;
     extern uint8_t KeyBacklightBrightnessDefault;
     extern uint8_t LedDriverValues[LED_DRIVER_MAX_COUNT][LED_DRIVER_LED_COUNT_MAX];
+    extern uint32_t LedDriverDirtyMasks[LED_DRIVER_MAX_COUNT][LED_DRIVER_DIRTY_MASK_WORD_COUNT];
+    extern uint32_t LedSlaveDriver_FrameCounter;
+    extern uint32_t LedSlaveDriver_FrameTimeUs;
+    extern uint32_t LedSlaveDriver_MaxFrameTimeUs;
 
 // Functions:
 
@@ -84,4 +101,18 @@
     void LedSlaveDriver_Init(uint8_t ledDriverId);
     slave_result_t LedSlaveDriver_Update(uint8_t ledDriverId);
 
+    // Values set between these are only sent once the outermost frame ends, so that they show up
+    // at once. Frames can be nested.
+    void LedSlaveDriver_BeginFrame(void);
+    void LedSlaveDriver_EndFrame(void);
+
+    // LedDriverValues must only be written through this, so that the driver knows what to send.
+    static inline void LedSlaveDriver_SetLedValue(uint8_t ledDriverId, uint8_t ledIndex, uint8_t value)
+    {
+        if (LedDriverValues[ledDriverId][ledIndex] != value) {
+            LedDriverValues[ledDriverId][ledIndex] = value;
+            LedDriverDirtyMasks[ledDriverId][ledIndex / LED_DRIVER_DIRTY_MASK_WORD_BITS] |= 1UL << (ledIndex % LED_DRIVER_DIRTY_MASK_WORD_BITS);
+        }
+    }
+
 #endif
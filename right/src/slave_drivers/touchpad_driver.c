@@ -12,6 +12,7 @@
 #include "debug.h"
 #include "timer.h"
 #include "macros.h"
+#include "attributes.h"
 
 /*
 |  Actually produced sequences:
@@ -67,7 +68,20 @@ typedef struct {
     } events1;
 } gesture_events_t;
 
-static gesture_events_t gestureEvents;
+// Contiguous register block starting at GestureEvents0 (0x000d), read in one burst.
+typedef struct {
+    gesture_events_t gestureEvents;
+    uint8_t systemInfo0;
+    uint8_t systemInfo1;
+    uint8_t noFingers;
+    uint8_t relativePixels[4];
+} ATTR_PACKED touchpad_registers_t;
+
+#define TOUCHPAD_REGISTERS_ADDRESS 0x000d
+#define TOUCHPAD_REGISTERS_ADDRESS_SIZE 2
+#define SYSTEM_INFO1_TP_MOVEMENT (1 << 0)
+
+static touchpad_registers_t registers;
 
 
 
@@ -88,12 +102,7 @@ static uint8_t enableManualMode[] = {0x05, 0x8e, 0xec};
 // report rate, so we set it to 1ms so that it is always prepared.
 static uint8_t setReportRate[] = {0x05, 0x7b, 0x01};
 
-static uint8_t getGestureEvents0[] = {0x00, 0x0d};
-static uint8_t getRelativePixelsXCommand[] = {0x00, 0x12};
 static uint8_t closeCommunicationWindow[] = {0xee, 0xee, 0xee};
-static uint8_t getNoFingers[] = {0x00, 0x11};
-static uint8_t buffer[5];
-uint8_t noFingers;
 int16_t deltaX;
 int16_t deltaY;
 
@@ -122,53 +131,32 @@ slave_result_t TouchpadDriver_Update(uint8_t uhkModuleDriverId)
             break;
         }
         case 3: {
-            res.status = I2cAsyncWrite(address, getGestureEvents0, sizeof(getGestureEvents0));
+            res.status = I2cAsyncReadRegisters(address, TOUCHPAD_REGISTERS_ADDRESS, TOUCHPAD_REGISTERS_ADDRESS_SIZE, (uint8_t*)&registers, sizeof(registers));
             phase = 4;
             break;
         }
         case 4: {
-            res.status = I2cAsyncRead(address, (uint8_t*)&gestureEvents, sizeof(gesture_events_t));
-            phase = 5;
-            break;
-        }
-        case 5: {
-            res.status = I2cAsyncWrite(address, getNoFingers, sizeof(getNoFingers));
-            phase = 6;
-            break;
-        }
-        case 6: {
-            res.status = I2cAsyncRead(address, &noFingers, 1);
-            phase = 7;
-            break;
-        }
-        case 7: {
-            res.status = I2cAsyncWrite(address, getRelativePixelsXCommand, sizeof(getRelativePixelsXCommand));
-            phase = 8;
-            break;
-        }
-        case 8: {
-            res.status = I2cAsyncRead(address, buffer, 5);
-            phase = 9;
-            break;
-        }
-        case 9: {
-            deltaY = (int16_t)(buffer[1] | buffer[0]<<8);
-            deltaX = (int16_t)(buffer[3] | buffer[2]<<8);
-
-
-            TouchpadEvents.singleTap = gestureEvents.events0.singleTap;
-            TouchpadEvents.twoFingerTap = gestureEvents.events1.twoFingerTap;
-            TouchpadEvents.tapAndHold = gestureEvents.events0.tapAndHold;
-            TouchpadEvents.noFingers = noFingers;
-
-            if (gestureEvents.events1.scroll) {
-                TouchpadEvents.wheelX -= deltaX;
-                TouchpadEvents.wheelY += deltaY;
-            } else if (gestureEvents.events1.zoom) {
-                TouchpadEvents.zoomLevel -= deltaY;
-            } else {
-                TouchpadEvents.x -= deltaX;
-                TouchpadEvents.y += deltaY;
+            gesture_events_t *gestureEvents = &registers.gestureEvents;
+
+            TouchpadEvents.singleTap = gestureEvents->events0.singleTap;
+            TouchpadEvents.twoFingerTap = gestureEvents->events1.twoFingerTap;
+            TouchpadEvents.tapAndHold = gestureEvents->events0.tapAndHold;
+            TouchpadEvents.noFingers = registers.noFingers;
+
+            // Relative pixels are valid only if the touchpad reports movement or a scroll/zoom gesture.
+            bool hasMovement = (registers.systemInfo1 & SYSTEM_INFO1_TP_MOVEMENT) || gestureEvents->events1.scroll || gestureEvents->events1.zoom;
+
+            if (hasMovement) {
+                deltaY = (int16_t)(registers.relativePixels[1] | registers.relativePixels[0]<<8);
+                deltaX = (int16_t)(registers.relativePixels[3] | registers.relativePixels[2]<<8);
+
+                if (gestureEvents->events1.scroll) {
+                    PointerSeqlock_Add(&TouchpadEvents.wheel, -deltaX, deltaY, CurrentTime);
+                } else if (gestureEvents->events1.zoom) {
+                    PointerSeqlock_Add(&TouchpadEvents.zoom, 0, -deltaY, CurrentTime);
+                } else {
+                    PointerSeqlock_Add(&TouchpadEvents.movement, -deltaX, deltaY, CurrentTime);
+                }
             }
 
             res.status = I2cAsyncWrite(address, closeCommunicationWindow, sizeof(closeCommunicationWindow));
@@ -183,7 +171,9 @@ slave_result_t TouchpadDriver_Update(uint8_t uhkModuleDriverId)
 
 void TouchpadDriver_Disconnect(uint8_t uhkModuleDriverId)
 {
-    TouchpadEvents.x = 0;
-    TouchpadEvents.y = 0;
+    // Movement that was pending when the module went away must not be applied after it's back.
+    PointerSeqlock_Discard(&TouchpadEvents.movement);
+    PointerSeqlock_Discard(&TouchpadEvents.wheel);
+    PointerSeqlock_Discard(&TouchpadEvents.zoom);
     phase = 0;
 }
@@ -8,6 +8,7 @@
     #include "slot.h"
     #include "usb_interfaces/usb_interface_mouse.h"
     #include "slave_scheduler.h"
+    #include "pointer_seqlock.h"
 
 // Typedefs:
 
@@ -19,12 +20,10 @@
         bool singleTap;
         bool tapAndHold;
         bool twoFingerTap;
-        int16_t x;
-        int16_t y;
-        int8_t wheelY;
-        int8_t wheelX;
-        int8_t zoomLevel;
         int8_t noFingers;
+        pointer_seqlock_t movement;
+        pointer_seqlock_t wheel;
+        pointer_seqlock_t zoom;
     } touchpad_events_t;
 
 // Variables:
@@ -12,6 +12,7 @@
 #include "keymap.h"
 #include "debug.h"
 #include "macros.h"
+#include "timer.h"
 
 uhk_module_state_t UhkModuleStates[UHK_MODULE_MAX_SLOT_COUNT];
 
@@ -79,8 +80,8 @@ void UhkModuleSlaveDriver_Init(uint8_t uhkModuleDriverId)
     uhkModuleState->firmwareI2cAddress = uhkModuleI2cAddresses->firmwareI2cAddress;
     uhkModuleState->bootloaderI2cAddress = uhkModuleI2cAddresses->bootloaderI2cAddress;
 
-    uhkModuleState->pointerDelta.x = 0;
-    uhkModuleState->pointerDelta.y = 0;
+    // Movement that was pending when the module went away must not be applied after it's back.
+    PointerSeqlock_Discard(&uhkModuleState->pointerDelta);
 }
 
 // When module is swapped, we need to reload its Keymap once we know its
@@ -332,8 +333,13 @@ slave_result_t UhkModuleSlaveDriver_Update(uint8_t uhkModuleDriverId)
                 if (uhkModuleState->pointerCount) {
                     uint8_t keyStatesLength = BOOL_BYTES_TO_BITS_COUNT(uhkModuleState->keyCount);
                     pointer_delta_t *pointerDelta = (pointer_delta_t*)(rxMessage->data + keyStatesLength);
-                    uhkModuleState->pointerDelta.x += pointerDelta->x;
-                    uhkModuleState->pointerDelta.y += pointerDelta->y;
+                    if (pointerDelta->x != 0 || pointerDelta->y != 0) {
+                        // Modules before protocol 4.3.0 don't timestamp their samples, so fall back to the time of reception.
+                        bool hasSampleTime = VERSION_AT_LEAST(uhkModuleState->moduleProtocolVersion, 4, 3, 0)
+                            && rxMessage->length >= keyStatesLength + sizeof(pointer_delta_t);
+                        uint16_t sampleTime = hasSampleTime ? pointerDelta->sampleTime : CurrentTime;
+                        PointerSeqlock_Add(&uhkModuleState->pointerDelta, pointerDelta->x, pointerDelta->y, sampleTime);
+                    }
                 }
             }
             res.status = kStatus_Uhk_IdleCycle;
@@ -9,6 +9,7 @@
     #include "versioning.h"
     #include "slot.h"
     #include "usb_interfaces/usb_interface_mouse.h"
+    #include "pointer_seqlock.h"
 
 // Macros:
 
@@ -97,7 +98,7 @@
         uint8_t bootloaderI2cAddress;
         uint8_t keyCount;
         uint8_t pointerCount;
-        pointer_delta_t pointerDelta;
+        pointer_seqlock_t pointerDelta;
         char gitRepo[MAX_STRING_PROPERTY_LENGTH];
         char gitTag[MAX_STRING_PROPERTY_LENGTH];
     } uhk_module_state_t;
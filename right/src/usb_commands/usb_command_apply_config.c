@@ -6,6 +6,8 @@
 #include "keymap.h"
 #include "macro_events.h"
 #include "macros.h"
+#include "crc32.h"
+#include "eeprom.h"
 
 void updateUsbBuffer(uint8_t usbStatusCode, uint16_t parserOffset, parser_stage_t parserStage)
 {
@@ -16,7 +18,14 @@ void updateUsbBuffer(uint8_t usbStatusCode, uint16_t parserOffset, parser_stage_
 
 void UsbCommand_ApplyConfig(void)
 {
-    // Validate the staging configuration.
+    // An ongoing EEPROM save may still be reading from either buffer, which the swap below would
+    // hand over to the next staging write.
+    if (IsEepromWriteInProgress()) {
+        updateUsbBuffer(UsbStatusCode_ApplyConfig_EepromBusy, 0, ParsingStage_Validate);
+        return;
+    }
+
+    // Validate the staging configuration, which also records everything that applying it takes.
 
     ParserRunDry = true;
     StagingUserConfigBuffer.offset = 0;
@@ -42,14 +51,16 @@ void UsbCommand_ApplyConfig(void)
         return;
     }
 
+    // The recorded references point into the buffer that has just become the validated one.
+
     ParserRunDry = false;
-    ValidatedUserConfigBuffer.offset = 0;
-    parseConfigStatus = ParseConfig(&ValidatedUserConfigBuffer);
-    updateUsbBuffer(parseConfigStatus, ValidatedUserConfigBuffer.offset, ParsingStage_Apply);
+    CommitParsedConfig();
 
-    if (parseConfigStatus != UsbStatusCode_Success) {
-        return;
-    }
+    // The checksum identifies the running config, and covers exactly the bytes that have been parsed.
+    ValidatedUserConfigCrcLength = StagingUserConfigBuffer.offset;
+    ValidatedUserConfigCrc = CRC32_Update(CRC32_INITIAL_VALUE, ValidatedUserConfigBuffer.buffer, ValidatedUserConfigCrcLength);
+
+    updateUsbBuffer(UsbStatusCode_Success, StagingUserConfigBuffer.offset, ParsingStage_Apply);
 
     Macros_ClearStatus();
 
@@ -8,6 +8,11 @@
         ParsingStage_Apply,
     } parser_stage_t;
 
+    // Above the range of parser_error_t, which the command reports otherwise.
+    typedef enum {
+        UsbStatusCode_ApplyConfig_EepromBusy = 0x80,
+    } usb_status_code_apply_config_t;
+
 // Functions:
 
     void UsbCommand_ApplyConfig(void);
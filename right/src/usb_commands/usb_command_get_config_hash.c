@@ -0,0 +1,15 @@
+#include "fsl_common.h"
+#include "usb_commands/usb_command_get_config_hash.h"
+#include "usb_protocol_handler.h"
+#include "config_parser/config_globals.h"
+#include "crc32.h"
+#include "eeprom.h"
+
+// Lets the agent skip uploading a config that is already in place. The user config checksum is
+// kept from when it was applied, the small hardware config is checksummed on the spot.
+void UsbCommand_GetConfigHash(void)
+{
+    SetUsbTxBufferUint32(1, ValidatedUserConfigCrc);
+    SetUsbTxBufferUint16(5, ValidatedUserConfigCrcLength);
+    SetUsbTxBufferUint32(7, CRC32_Update(CRC32_INITIAL_VALUE, HardwareConfigBuffer.buffer, HARDWARE_CONFIG_SIZE));
+}
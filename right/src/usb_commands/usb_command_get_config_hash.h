@@ -0,0 +1,8 @@
+#ifndef __USB_COMMAND_GET_CONFIG_HASH_H__
+#define __USB_COMMAND_GET_CONFIG_HASH_H__
+
+// Functions:
+
+    void UsbCommand_GetConfigHash(void);
+
+#endif
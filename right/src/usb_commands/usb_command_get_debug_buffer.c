@@ -3,6 +3,7 @@
 #include "usb_protocol_handler.h"
 #include "slave_scheduler.h"
 #include "i2c_watchdog.h"
+#include "eeprom.h"
 #include "buffer.h"
 #include "timer.h"
 #include "right_key_matrix.h"
@@ -12,6 +13,7 @@
 #include "usb_interfaces/usb_interface_system_keyboard.h"
 #include "usb_interfaces/usb_interface_mouse.h"
 #include "usb_interfaces/usb_interface_gamepad.h"
+#include "slave_drivers/is31fl3xxx_driver.h"
 
 uint8_t DebugBuffer[USB_GENERIC_HID_IN_BUFFER_LENGTH];
 
@@ -30,6 +32,9 @@ void UsbCommand_GetDebugBuffer(void)
     SetDebugBufferUint32(41, UsbSystemKeyboardActionCounter);
     SetDebugBufferUint32(45, UsbMouseActionCounter);
     SetDebugBufferUint32(49, UsbGamepadActionCounter);
+    SetDebugBufferUint32(53, EepromWritePollCounter);
+    SetDebugBufferUint32(57, EepromWriteFailureCounter);
+    SetDebugBufferUint16(61, MIN(LedSlaveDriver_MaxFrameTimeUs, UINT16_MAX));
 
     memcpy(GenericHidInBuffer, DebugBuffer, USB_GENERIC_HID_IN_BUFFER_LENGTH);
 }
@@ -20,5 +20,6 @@ void UsbCommand_GetKeyboardState(void)
         : UhkModuleStates[UhkModuleDriverId_RightModule].moduleId;
     SetUsbTxBufferUint8(5, rightSlotModuleId);
     SetUsbTxBufferUint8(6, ActiveLayer | (ActiveLayer != LayerId_Base && !ActiveLayerHeld ? (1 << 7) : 0) ); //Active layer + most significant bit if layer is toggled
+    SetUsbTxBufferUint8(7, HasEepromWriteFailed); // The last EEPROM write was given up, so the saved config is incomplete
     LastUsbGetKeyboardStateRequestTimestamp = CurrentTime;
 }
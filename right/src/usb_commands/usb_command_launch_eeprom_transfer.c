@@ -8,6 +8,7 @@ void UsbCommand_LaunchEepromTransfer(void)
 {
     eeprom_operation_t eepromOperation = GetUsbRxBufferUint8(1);
     config_buffer_id_t configBufferId = GetUsbRxBufferUint8(2);
+    uint8_t flags = GetUsbRxBufferUint8(3);
 
     if (!IsEepromOperationValid(eepromOperation)) {
         SetUsbTxBufferUint8(0, UsbStatusCode_LaunchEepromTransfer_InvalidEepromOperation);
@@ -17,6 +18,7 @@ void UsbCommand_LaunchEepromTransfer(void)
         SetUsbTxBufferUint8(0, UsbStatusCode_LaunchEepromTransfer_InvalidConfigBufferId);
     }
 
+    IsUserConfigCompressionRequested = flags & EEPROM_TRANSFER_FLAG_COMPRESS_USER_CONFIG;
     status_t status = EEPROM_LaunchTransfer(eepromOperation, configBufferId, NULL);
     if (status != kStatus_Success) {
         SetUsbTxBufferUint8(0, UsbStatusCode_LaunchEepromTransfer_TransferError);
@@ -1,6 +1,10 @@
 #ifndef __USB_COMMAND_LAUNCH_EEPROM_TRANSFER_H__
 #define __USB_COMMAND_LAUNCH_EEPROM_TRANSFER_H__
 
+// Macros:
+
+    #define EEPROM_TRANSFER_FLAG_COMPRESS_USER_CONFIG (1 << 0)
+
 // Typedef
 
     typedef enum {
@@ -0,0 +1,74 @@
+#include "fsl_common.h"
+#include "usb_commands/usb_command_stream_config.h"
+#include "usb_protocol_handler.h"
+#include "config_parser/config_globals.h"
+#include "crc32.h"
+#include "eeprom.h"
+
+static uint8_t expectedSequence;
+static uint8_t pendingStatus = UsbStatusCode_Success;
+static uint32_t receivedCrc = CRC32_INITIAL_VALUE;
+
+// Packets are only accepted in sequence. Anything else is dropped, and the first problem since the
+// last acknowledgement is reported by the next one, so that the agent can resend from the expected
+// sequence number onwards.
+static void receivePacket(uint8_t flags, uint8_t sequence, uint8_t length, uint16_t offset)
+{
+    if (flags & UsbStreamConfigFlag_Start) {
+        expectedSequence = sequence;
+        pendingStatus = UsbStatusCode_Success;
+        receivedCrc = CRC32_INITIAL_VALUE;
+    }
+
+    if (sequence != expectedSequence) {
+        if (pendingStatus == UsbStatusCode_Success) {
+            pendingStatus = UsbStatusCode_StreamConfig_SequenceError;
+        }
+        return;
+    }
+
+    if (length > USB_GENERIC_HID_OUT_BUFFER_LENGTH - USB_STREAM_CONFIG_PARAMS_SIZE) {
+        pendingStatus = UsbStatusCode_StreamConfig_LengthTooLarge;
+        return;
+    }
+
+    if (offset + length > USER_CONFIG_SIZE) {
+        pendingStatus = UsbStatusCode_StreamConfig_BufferOutOfBounds;
+        return;
+    }
+
+    // An ongoing EEPROM save may still be reading from the staging buffer.
+    if (IsEepromWriteInProgress()) {
+        pendingStatus = UsbStatusCode_StreamConfig_EepromBusy;
+        return;
+    }
+
+    const uint8_t *data = GenericHidOutBuffer + USB_STREAM_CONFIG_PARAMS_SIZE;
+    memcpy(StagingUserConfigBuffer.buffer + offset, data, length);
+    receivedCrc = CRC32_Update(receivedCrc, data, length);
+    expectedSequence++;
+}
+
+// Writes the staging user config without a round trip per packet. Only packets that request an
+// acknowledgement get a response, which carries the status, the next expected sequence number and
+// the CRC32 of the data accepted since the start of the transfer.
+bool UsbCommand_StreamConfig(void)
+{
+    uint8_t flags = GetUsbRxBufferUint8(1);
+    uint8_t sequence = GetUsbRxBufferUint8(2);
+    uint8_t length = GetUsbRxBufferUint8(3);
+    uint16_t offset = GetUsbRxBufferUint16(4);
+
+    receivePacket(flags, sequence, length, offset);
+
+    if (!(flags & UsbStreamConfigFlag_AckRequest)) {
+        return false;
+    }
+
+    bzero(GenericHidInBuffer, USB_GENERIC_HID_IN_BUFFER_LENGTH);
+    SetUsbTxBufferUint8(0, pendingStatus);
+    SetUsbTxBufferUint8(1, expectedSequence);
+    SetUsbTxBufferUint32(2, receivedCrc);
+    pendingStatus = UsbStatusCode_Success;
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef __USB_COMMAND_STREAM_CONFIG_H__
+#define __USB_COMMAND_STREAM_CONFIG_H__
+
+// Includes:
+
+    #include "fsl_common.h"
+
+// Macros:
+
+    #define USB_STREAM_CONFIG_PARAMS_SIZE 6
+
+// Typedefs:
+
+    typedef enum {
+        UsbStreamConfigFlag_Start      = 1 << 0,
+        UsbStreamConfigFlag_AckRequest = 1 << 1,
+    } usb_stream_config_flag_t;
+
+    typedef enum {
+        UsbStatusCode_StreamConfig_LengthTooLarge    = 2,
+        UsbStatusCode_StreamConfig_BufferOutOfBounds = 3,
+        UsbStatusCode_StreamConfig_SequenceError     = 4,
+        UsbStatusCode_StreamConfig_EepromBusy        = 5,
+    } usb_status_code_stream_config_t;
+
+// Functions:
+
+    bool UsbCommand_StreamConfig(void);
+
+#endif
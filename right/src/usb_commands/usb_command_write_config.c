@@ -22,5 +22,11 @@ void UsbCommand_WriteConfig(config_buffer_id_t configBufferId)
         return;
     }
 
+    // An ongoing EEPROM save may still be reading from the buffer.
+    if (IsEepromWriteInProgress()) {
+        SetUsbTxBufferUint8(0, UsbStatusCode_WriteConfig_EepromBusy);
+        return;
+    }
+
     memcpy(buffer + offset, GenericHidOutBuffer + paramsSize, length);
 }
@@ -10,6 +10,7 @@
     typedef enum {
         UsbStatusCode_WriteConfig_LengthTooLarge    = 2,
         UsbStatusCode_WriteConfig_BufferOutOfBounds = 3,
+        UsbStatusCode_WriteConfig_EepromBusy        = 4,
     } usb_status_code_write_config_t;
 
 // Functions:
@@ -4,6 +4,7 @@
 // Includes:
 
     #include "usb_api.h"
+    #include "usb_interfaces/usb_interface_mouse.h"
 
 // Macros:
 
@@ -57,6 +58,16 @@
 
                 HID_RI_COLLECTION(8, HID_RI_COLLECTION_LOGICAL),
 
+                    // Vertical wheel resolution multiplier
+                    HID_RI_USAGE(8, HID_RI_USAGE_GENERIC_DESKTOP_RESOLUTION_MULTIPLIER),
+                    HID_RI_LOGICAL_MINIMUM(8, 0),
+                    HID_RI_LOGICAL_MAXIMUM(8, 1),
+                    HID_RI_PHYSICAL_MINIMUM(8, 1),
+                    HID_RI_PHYSICAL_MAXIMUM(8, USB_MOUSE_WHEEL_RESOLUTION_MULTIPLIER),
+                    HID_RI_REPORT_COUNT(8, 1),
+                    HID_RI_REPORT_SIZE(8, 2),
+                    HID_RI_FEATURE(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+
                     // Vertical wheel
                     HID_RI_USAGE(8, HID_RI_USAGE_GENERIC_DESKTOP_WHEEL),
                     HID_RI_LOGICAL_MINIMUM(8, -127),
@@ -71,6 +82,16 @@
 
                 HID_RI_COLLECTION(8, HID_RI_COLLECTION_LOGICAL),
 
+                    // Horizontal wheel resolution multiplier
+                    HID_RI_USAGE(8, HID_RI_USAGE_GENERIC_DESKTOP_RESOLUTION_MULTIPLIER),
+                    HID_RI_LOGICAL_MINIMUM(8, 0),
+                    HID_RI_LOGICAL_MAXIMUM(8, 1),
+                    HID_RI_PHYSICAL_MINIMUM(8, 1),
+                    HID_RI_PHYSICAL_MAXIMUM(8, USB_MOUSE_WHEEL_RESOLUTION_MULTIPLIER),
+                    HID_RI_REPORT_COUNT(8, 1),
+                    HID_RI_REPORT_SIZE(8, 2),
+                    HID_RI_FEATURE(8, HID_IOF_DATA | HID_IOF_VARIABLE | HID_IOF_ABSOLUTE),
+
                     // Horizontal wheel
                     HID_RI_USAGE_PAGE(8, HID_RI_USAGE_PAGE_CONSUMER),
                     HID_RI_USAGE(16, HID_RI_USAGE_CONSUMER_AC_PAN),
@@ -84,6 +105,11 @@
 
                 HID_RI_END_COLLECTION(0),
 
+                // Resolution multiplier padding
+                HID_RI_REPORT_COUNT(8, 1),
+                HID_RI_REPORT_SIZE(8, 4),
+                HID_RI_FEATURE(8, HID_IOF_CONSTANT),
+
             HID_RI_END_COLLECTION(0),
         HID_RI_END_COLLECTION(0)
     };
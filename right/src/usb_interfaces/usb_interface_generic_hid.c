@@ -50,12 +50,12 @@ usb_status_t UsbGenericHidCallback(class_handle_t handle, uint32_t event, void *
             break;
 
         case kUSB_DeviceHidEventRecvResponse:
-            UsbProtocolHandler();
-
-            USB_DeviceHidSend(UsbCompositeDevice.genericHidHandle,
-                              USB_GENERIC_HID_ENDPOINT_IN_INDEX,
-                              GenericHidInBuffer,
-                              USB_GENERIC_HID_IN_BUFFER_LENGTH);
+            if (UsbProtocolHandler()) {
+                USB_DeviceHidSend(UsbCompositeDevice.genericHidHandle,
+                                  USB_GENERIC_HID_ENDPOINT_IN_INDEX,
+                                  GenericHidInBuffer,
+                                  USB_GENERIC_HID_IN_BUFFER_LENGTH);
+            }
             UsbGenericHidActionCounter++;
             error = UsbReceiveData();
             break;
@@ -6,6 +6,11 @@ usb_hid_protocol_t usbMouseProtocol;
 uint32_t UsbMouseActionCounter;
 usb_mouse_report_t* ActiveUsbMouseReport = usbMouseReports;
 
+// Hosts that support high-resolution scrolling enable the multipliers through this feature report.
+// Until they do, wheel values are whole detents.
+static uint8_t usbMouseFeatureReport;
+static uint8_t usbMouseFeatureOutBuffer[USB_MOUSE_FEATURE_REPORT_LENGTH];
+
 static usb_mouse_report_t* GetInactiveUsbMouseReport(void)
 {
     return ActiveUsbMouseReport == usbMouseReports ? usbMouseReports+1 : usbMouseReports;
@@ -26,6 +31,20 @@ usb_hid_protocol_t UsbMouseGetProtocol(void)
     return usbMouseProtocol;
 }
 
+uint8_t UsbMouseGetVerticalWheelMultiplier(void)
+{
+    return (usbMouseFeatureReport & USB_MOUSE_FEATURE_VERTICAL_WHEEL_MULTIPLIER_MASK)
+        ? USB_MOUSE_WHEEL_RESOLUTION_MULTIPLIER
+        : 1;
+}
+
+uint8_t UsbMouseGetHorizontalWheelMultiplier(void)
+{
+    return (usbMouseFeatureReport & USB_MOUSE_FEATURE_HORIZONTAL_WHEEL_MULTIPLIER_MASK)
+        ? USB_MOUSE_WHEEL_RESOLUTION_MULTIPLIER
+        : 1;
+}
+
 usb_status_t UsbMouseAction(void)
 {
     if (!UsbCompositeDevice.attach) {
@@ -69,6 +88,8 @@ usb_status_t UsbMouseCallback(class_handle_t handle, uint32_t event, void *param
 
     switch (event) {
         case ((uint32_t)-kUSB_DeviceEventSetConfiguration):
+            // The multipliers fall back to their defaults whenever the device gets reconfigured.
+            usbMouseFeatureReport = 0;
             error = kStatus_USB_Success;
             break;
         case ((uint32_t)-kUSB_DeviceEventSetInterface):
@@ -91,11 +112,35 @@ usb_status_t UsbMouseCallback(class_handle_t handle, uint32_t event, void *param
                 UsbMouseActionCounter++;
                 SwitchActiveUsbMouseReport();
                 error = kStatus_USB_Success;
+            } else if (report->reportType == USB_DEVICE_HID_REQUEST_GET_REPORT_TYPE_FEATURE && report->reportId == 0 && report->reportLength <= USB_MOUSE_FEATURE_REPORT_LENGTH) {
+                report->reportBuffer = &usbMouseFeatureReport;
+                error = kStatus_USB_Success;
+            } else {
+                error = kStatus_USB_InvalidRequest;
+            }
+            break;
+        }
+
+        case kUSB_DeviceHidEventSetReport: {
+            usb_device_hid_report_struct_t *report = (usb_device_hid_report_struct_t*)param;
+            if (report->reportType == USB_DEVICE_HID_REQUEST_GET_REPORT_TYPE_FEATURE && report->reportId == 0 && report->reportLength == USB_MOUSE_FEATURE_REPORT_LENGTH) {
+                usbMouseFeatureReport = report->reportBuffer[0];
+                error = kStatus_USB_Success;
             } else {
                 error = kStatus_USB_InvalidRequest;
             }
             break;
         }
+        case kUSB_DeviceHidEventRequestReportBuffer: {
+            usb_device_hid_report_struct_t *report = (usb_device_hid_report_struct_t*)param;
+            if (report->reportLength <= sizeof(usbMouseFeatureOutBuffer)) {
+                report->reportBuffer = usbMouseFeatureOutBuffer;
+                error = kStatus_USB_Success;
+            } else {
+                error = kStatus_USB_AllocFail;
+            }
+            break;
+        }
 
         case kUSB_DeviceHidEventSetProtocol: {
             uint8_t report = *(uint16_t*)param;
@@ -19,6 +19,15 @@
 
     #define USB_MOUSE_REPORT_LENGTH (sizeof(usb_mouse_report_t))
 
+    // Wheel units per detent once the host enables the resolution multiplier. The wheel fields
+    // are 8-bit, so the multiplier has to stay well below 127.
+    #define USB_MOUSE_WHEEL_RESOLUTION_MULTIPLIER 16
+
+    // Feature report holding the wheel resolution multipliers, 2 bits each.
+    #define USB_MOUSE_FEATURE_REPORT_LENGTH 1
+    #define USB_MOUSE_FEATURE_VERTICAL_WHEEL_MULTIPLIER_MASK 0x03
+    #define USB_MOUSE_FEATURE_HORIZONTAL_WHEEL_MULTIPLIER_MASK 0x0c
+
 // Typedefs:
 
     // Note: We support boot protocol mode in this interface, thus the mouse
@@ -45,6 +54,8 @@
     usb_status_t UsbMouseCallback(class_handle_t handle, uint32_t event, void *param);
 
     usb_hid_protocol_t UsbMouseGetProtocol(void);
+    uint8_t UsbMouseGetVerticalWheelMultiplier(void);
+    uint8_t UsbMouseGetHorizontalWheelMultiplier(void);
     void UsbMouseResetActiveReport(void);
     usb_status_t UsbMouseAction(void);
     usb_status_t UsbMouseCheckIdleElapsed();
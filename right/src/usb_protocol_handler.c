@@ -20,11 +20,20 @@
 #include "usb_commands/usb_command_get_variable.h"
 #include "usb_commands/usb_command_set_variable.h"
 #include "usb_commands/usb_command_exec_macro_command.h"
+#include "usb_commands/usb_command_stream_config.h"
+#include "usb_commands/usb_command_get_config_hash.h"
 
-void UsbProtocolHandler(void)
+bool UsbProtocolHandler(void)
 {
-    bzero(GenericHidInBuffer, USB_GENERIC_HID_IN_BUFFER_LENGTH);
     uint8_t command = GetUsbRxBufferUint8(0);
+
+    // Most packets of a stream don't get a response, and mustn't touch the previous one, which may
+    // still be waiting to be sent.
+    if (command == UsbCommandId_StreamConfig) {
+        return UsbCommand_StreamConfig();
+    }
+
+    bzero(GenericHidInBuffer, USB_GENERIC_HID_IN_BUFFER_LENGTH);
     switch (command) {
         case UsbCommandId_GetDeviceProperty:
             UsbCommand_GetDeviceProperty();
@@ -89,10 +98,14 @@ void UsbProtocolHandler(void)
         case UsbCommandId_ExecMacroCommand:
             UsbCommand_ExecMacroCommand();
             break;
+        case UsbCommandId_GetConfigHash:
+            UsbCommand_GetConfigHash();
+            break;
         default:
             SetUsbTxBufferUint8(0, UsbStatusCode_InvalidCommand);
             break;
     }
+    return true;
 }
 
 uint8_t GetUsbRxBufferUint8(uint32_t offset)
@@ -37,6 +37,8 @@
         UsbCommandId_GetVariable              = 0x12,
         UsbCommandId_SetVariable              = 0x13,
         UsbCommandId_ExecMacroCommand         = 0x14,
+        UsbCommandId_StreamConfig             = 0x15,
+        UsbCommandId_GetConfigHash            = 0x16,
     } usb_command_id_t;
 
     typedef enum {
@@ -58,7 +60,7 @@
 
 // Functions:
 
-    void UsbProtocolHandler(void);
+    bool UsbProtocolHandler(void);
 
     uint8_t GetUsbRxBufferUint8(uint32_t offset);
     uint16_t GetUsbRxBufferUint16(uint32_t offset);
@@ -59,6 +59,7 @@ static void applyLayerHolds(key_state_t *keyState, key_action_t *action) {
         switch(action->switchLayer.mode) {
             case SwitchLayerMode_HoldAndDoubleTapToggle:
             case SwitchLayerMode_Hold:
+            case SwitchLayerMode_OneShot:
                 LayerSwitcher_HoldLayer(action->switchLayer.layer, false);
                 break;
             case SwitchLayerMode_Toggle:
@@ -100,12 +101,91 @@ static void applyToggleLayerAction(key_state_t *keyState, key_action_t *action)
                 LayerSwitcher_UnToggleLayerOnly(action->switchLayer.layer);
             }
             break;
+        case SwitchLayerMode_OneShot:
+            if (KeyState_ActivatedNow(keyState)) {
+                LayerSwitcher_UnToggleLayerOnly(action->switchLayer.layer);
+            }
+            LayerSwitcher_OneShot(action->switchLayer.layer, keyState);
+            break;
+    }
+}
+
+// One-shot modifiers act as regular modifiers while held. If released without
+// any other key being activated meanwhile, they get armed and are applied to
+// the next activated key for as long as that key stays active. Layer switchers
+// and other one-shot modifiers don't consume them, so they can be combined.
+// Armed modifiers are dropped after OneShotTimeout (if nonzero).
+static uint8_t oneShotModifiers;
+static uint8_t oneShotModifiersArmed;
+static key_state_t* oneShotModifierKey;
+static key_state_t* oneShotModifierConsumer;
+static bool oneShotModifierInterrupted;
+static uint32_t oneShotModifiersArmedTime;
+
+static void applyOneShotModifiersAction(key_state_t *keyState, key_action_t *action)
+{
+    if (KeyState_ActivatedNow(keyState)) {
+        oneShotModifierKey = keyState;
+        oneShotModifierInterrupted = false;
+    }
+
+    if (KeyState_Active(keyState)) {
+        InputModifiers |= action->oneShotModifiers.modifiers;
+    } else if (KeyState_DeactivatedNow(keyState)) {
+        if (oneShotModifierKey == keyState && !oneShotModifierInterrupted) {
+            oneShotModifiersArmed |= action->oneShotModifiers.modifiers;
+            oneShotModifiersArmedTime = CurrentTime;
+        }
+        if (oneShotModifierKey == keyState) {
+            oneShotModifierKey = NULL;
+        }
+    }
+}
+
+static void oneShotModifiersInterrupt(key_state_t *keyState, key_action_t *action)
+{
+    if (keyState != oneShotModifierKey) {
+        oneShotModifierInterrupted = true;
+    }
+
+    if (oneShotModifiersArmed == 0) {
+        return;
+    }
+
+    switch (action->type) {
+        case KeyActionType_OneShotModifiers:
+        case KeyActionType_SwitchLayer:
+        case KeyActionType_None:
+            return;
+        default:
+            oneShotModifiers = oneShotModifiersArmed;
+            oneShotModifiersArmed = 0;
+            oneShotModifierConsumer = keyState;
+            break;
     }
 }
 
-static void handleEventInterrupts(key_state_t *keyState) {
+static void applyOneShotModifiers()
+{
+    if (oneShotModifiersArmed && OneShotTimeout && Timer_GetElapsedTime(&oneShotModifiersArmedTime) > OneShotTimeout) {
+        oneShotModifiersArmed = 0;
+    }
+
+    if (oneShotModifierConsumer != NULL) {
+        if (KeyState_NonZero(oneShotModifierConsumer)) {
+            InputModifiers |= oneShotModifiers;
+        } else {
+            oneShotModifierConsumer = NULL;
+            oneShotModifiers = 0;
+        }
+    }
+}
+
+static void handleEventInterrupts(key_state_t *keyState, key_action_t *action) {
     if(KeyState_ActivatedNow(keyState)) {
         LayerSwitcher_DoubleTapInterrupt(keyState);
+        LayerSwitcher_OneShotInterrupt(keyState, action);
+        oneShotModifiersInterrupt(keyState, action);
     }
 }
 
@@ -292,6 +372,9 @@ void ApplyKeyAction(key_state_t *keyState, key_action_cached_t *cachedAction, ke
                 Macros_StartMacro(action->playMacro.macroId, keyState, 255, true);
             }
             break;
+        case KeyActionType_OneShotModifiers:
+            applyOneShotModifiersAction(keyState, action);
+            break;
     }
 }
 
@@ -304,6 +387,14 @@ static void clearActiveReports(void)
 }
 
 
+// The resolution multiplier can push macro wheel steps past the range of the report, so the sum
+// saturates like the wheel output of the mouse controller does.
+static void addToWheel(int8_t *wheel, int16_t amount)
+{
+    int16_t sum = *wheel + amount;
+    *wheel = MAX(MIN(sum, INT8_MAX), -INT8_MAX);
+}
+
 static void mergeReports(void)
 {
     for(uint8_t j = 0; j < MACRO_STATE_POOL_SIZE; j++) {
@@ -321,8 +412,8 @@ static void mergeReports(void)
             ActiveUsbMouseReport->buttons |= s->ms.macroMouseReport.buttons;
             ActiveUsbMouseReport->x += s->ms.macroMouseReport.x;
             ActiveUsbMouseReport->y += s->ms.macroMouseReport.y;
-            ActiveUsbMouseReport->wheelX += s->ms.macroMouseReport.wheelX;
-            ActiveUsbMouseReport->wheelY += s->ms.macroMouseReport.wheelY;
+            addToWheel(&ActiveUsbMouseReport->wheelX, s->ms.macroMouseReport.wheelX * UsbMouseGetHorizontalWheelMultiplier());
+            addToWheel(&ActiveUsbMouseReport->wheelY, s->ms.macroMouseReport.wheelY * UsbMouseGetVerticalWheelMultiplier());
         }
     }
 }
@@ -455,7 +546,7 @@ static void updateActiveUsbReports(void)
                     } else {
                         actionCache[slotId][keyId].action = CurrentKeymap[ActiveLayer][slotId][keyId];
                     }
-                    handleEventInterrupts(keyState);
+                    handleEventInterrupts(keyState, &actionCache[slotId][keyId].action);
                 }
 
                 cachedAction = &actionCache[slotId][keyId];
@@ -472,6 +563,8 @@ static void updateActiveUsbReports(void)
         }
     }
 
+    applyOneShotModifiers();
+
     MouseController_ProcessMouseActions();
 
     PostponerCore_FinishCycle();
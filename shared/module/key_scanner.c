@@ -3,12 +3,19 @@
 #include "module/i2c_watchdog.h"
 #include "module.h"
 
+volatile uint32_t CurrentTime;
+
 void KEY_SCANNER_HANDLER(void)
 {
     #if KEY_ARRAY_TYPE == KEY_ARRAY_TYPE_VECTOR
         KeyVector_Scan(&KeyVector);
+        CurrentTime++;
     #elif KEY_ARRAY_TYPE == KEY_ARRAY_TYPE_MATRIX
         KeyMatrix_ScanRow(&KeyMatrix);
+        // The timer fires once per row, so a millisecond has passed when the scan wraps around.
+        if (KeyMatrix.currentRowNum == 0) {
+            CurrentTime++;
+        }
     #endif
     RunWatchdog();
     Module_OnScan();
@@ -13,6 +13,10 @@
     #define KEY_SCANNER_LPTMR_IRQ_ID   LPTMR0_IRQn
     #define KEY_SCANNER_HANDLER        LPTMR0_IRQHandler
 
+// Variables:
+
+    extern volatile uint32_t CurrentTime;
+
 // Functions:
 
     void InitKeyScanner(void);
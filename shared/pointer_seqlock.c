@@ -0,0 +1,66 @@
+#include "pointer_seqlock.h"
+
+static int16_t saturateToInt16(int32_t value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    } else if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return value;
+}
+
+void PointerSeqlock_Add(pointer_seqlock_t *seqlock, int16_t x, int16_t y, uint16_t sampleTime)
+{
+    seqlock->sequence++;
+    seqlock->x += (int32_t)x;
+    seqlock->y += (int32_t)y;
+    seqlock->sampleTime = sampleTime;
+    seqlock->sequence++;
+}
+
+// Drops whatever hasn't been taken yet. The producer can't touch the counters of the consumer, so
+// it only records the totals, and the consumer catches up to them on its next take.
+void PointerSeqlock_Discard(pointer_seqlock_t *seqlock)
+{
+    seqlock->sequence++;
+    seqlock->discardedX = seqlock->x;
+    seqlock->discardedY = seqlock->y;
+    seqlock->discardCount++;
+    seqlock->sequence++;
+}
+
+// Returns false and a zero delta if the producer was caught in the middle of an update, which
+// happens when the consumer runs in an interrupt that preempted the producer, or the other way
+// around.
+bool PointerSeqlock_Take(pointer_seqlock_t *seqlock, pointer_delta_t *delta)
+{
+    uint32_t sequence = seqlock->sequence;
+    uint32_t x = seqlock->x;
+    uint32_t y = seqlock->y;
+    uint16_t sampleTime = seqlock->sampleTime;
+    uint32_t discardedX = seqlock->discardedX;
+    uint32_t discardedY = seqlock->discardedY;
+    uint8_t discardCount = seqlock->discardCount;
+
+    if ((sequence & 1) || sequence != seqlock->sequence) {
+        delta->x = 0;
+        delta->y = 0;
+        delta->sampleTime = 0;
+        return false;
+    }
+
+    if (discardCount != seqlock->takenDiscardCount) {
+        seqlock->takenX = discardedX;
+        seqlock->takenY = discardedY;
+        seqlock->takenDiscardCount = discardCount;
+    }
+
+    // Whatever doesn't fit into the delta stays pending for the next take.
+    delta->x = saturateToInt16((int32_t)(x - seqlock->takenX));
+    delta->y = saturateToInt16((int32_t)(y - seqlock->takenY));
+    delta->sampleTime = sampleTime;
+    seqlock->takenX += (int32_t)delta->x;
+    seqlock->takenY += (int32_t)delta->y;
+    return true;
+}
@@ -0,0 +1,34 @@
+#ifndef __POINTER_SEQLOCK_H__
+#define __POINTER_SEQLOCK_H__
+
+// Includes:
+
+    #include <stdint.h>
+    #include <stdbool.h>
+    #include "slave_protocol.h"
+
+// Typedefs:
+
+    // Hands pointer deltas over from a single producer to a single consumer without masking
+    // interrupts. The producer only ever adds to running totals, and the consumer remembers how
+    // much it has already taken, so a failed read loses nothing, it is just picked up next time.
+    typedef struct {
+        volatile uint32_t sequence; // odd while the producer is writing
+        volatile uint32_t x; // two's complement running totals, allowed to wrap around
+        volatile uint32_t y;
+        volatile uint16_t sampleTime;
+        volatile uint32_t discardedX; // totals up to the last discard
+        volatile uint32_t discardedY;
+        volatile uint8_t discardCount;
+        uint32_t takenX; // owned by the consumer
+        uint32_t takenY; // owned by the consumer
+        uint8_t takenDiscardCount; // owned by the consumer
+    } pointer_seqlock_t;
+
+// Functions:
+
+    void PointerSeqlock_Add(pointer_seqlock_t *seqlock, int16_t x, int16_t y, uint16_t sampleTime);
+    void PointerSeqlock_Discard(pointer_seqlock_t *seqlock);
+    bool PointerSeqlock_Take(pointer_seqlock_t *seqlock, pointer_delta_t *delta);
+
+#endif
@@ -66,6 +66,7 @@
     typedef struct {
         int16_t x;
         int16_t y;
+        uint16_t sampleTime; // Module time of the latest accumulated sample in ms, wraps around. Since module protocol 4.3.0.
     } ATTR_PACKED pointer_delta_t;
 
 // Variables:
@@ -0,0 +1,117 @@
+#include <math.h>
+#include "test.h"
+#include "acceleration_curve.h"
+
+// The multiplier equals 1.0 at this speed in px/ms, as in the mouse controller.
+#define MID_SPEED 3.0f
+
+// Speeds beyond the table extrapolate its last segment, which only matches linear curves.
+#define TABLE_SPEED_MAX ((float)(ACCELERATION_CURVE_SEGMENT_COUNT << ACCELERATION_CURVE_STEP_BITS) / ACCELERATION_CURVE_SPEED_ONE)
+
+// The largest multiplier that the fixed-point format holds.
+#define MULTIPLIER_MAX ((float)INT32_MAX / ACCELERATION_CURVE_MULTIPLIER_ONE)
+
+#define DELTA_MAX 64
+#define ELAPSED_TIME_MAX 20
+
+typedef struct {
+    const char *name;
+    float baseSpeed;
+    float speed;
+    float xceleration;
+    float maxRelativeError; // of the fixed-point multiplier against the float one
+} curve_case_t;
+
+// The module defaults, plus the steepest xceleration that module.c suggests. Linear curves are
+// only off by the magnitude approximation. Steeper curves also amplify it, and linear interpolation
+// between points 0.5 px/ms apart overestimates them between the points.
+static const curve_case_t curveCases[] = {
+    {"key cluster", 5.0f, 0.0f, 0.0f, 0.001f},
+    {"trackball", 0.5f, 0.5f, 1.0f, 0.015f},
+    {"trackpoint", 0.0f, 1.0f, 0.0f, 0.001f},
+    {"touchpad", 0.5f, 0.7f, 1.0f, 0.015f},
+    {"next", 0.5f, 1.0f, 5.0f, 0.11f},
+    {"steepest", 0.5f, 1.0f, 10.0f, 0.40f},
+};
+
+// The multiplier as computeModuleSpeed of the mouse controller used to compute it in floating
+// point, before the curve table, with an exact power function.
+static float referenceMultiplier(const curve_case_t *curveCase, int16_t x, int16_t y, uint16_t elapsedTime)
+{
+    float distance = sqrt(x*x + y*y);
+    float speed = distance / (elapsedTime + 1);
+    return curveCase->baseSpeed + curveCase->speed * powf(speed / MID_SPEED, curveCase->xceleration);
+}
+
+static float fixedPointMultiplier(const acceleration_curve_t *curve, int16_t x, int16_t y, uint16_t elapsedTime)
+{
+    int32_t fixedX = (int32_t)x << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+    int32_t fixedY = (int32_t)y << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+    uint32_t speed = AccelerationCurve_Magnitude(fixedX, fixedY) / (elapsedTime + 1);
+    return (float)AccelerationCurve_Evaluate(curve, speed) / ACCELERATION_CURVE_MULTIPLIER_ONE;
+}
+
+// Compares every delta and sample interval of the range whose speed the table covers, or all of
+// them for curves that extrapolate exactly.
+static void testCurveMatchesReference(const curve_case_t *curveCase)
+{
+    acceleration_curve_t curve;
+    float maxRelativeError = 0;
+    uint32_t comparisonCount = 0;
+    bool isLinear = curveCase->xceleration == 0.0f || curveCase->xceleration == 1.0f;
+
+    AccelerationCurve_Build(&curve, curveCase->baseSpeed, curveCase->speed, curveCase->xceleration, MID_SPEED);
+
+    for (int16_t x = -DELTA_MAX; x <= DELTA_MAX; x++) {
+        for (int16_t y = -DELTA_MAX; y <= DELTA_MAX; y++) {
+            for (uint16_t elapsedTime = 0; elapsedTime <= ELAPSED_TIME_MAX; elapsedTime++) {
+                if (!isLinear && sqrt(x*x + y*y) / (elapsedTime + 1) > TABLE_SPEED_MAX) {
+                    continue;
+                }
+                float reference = referenceMultiplier(curveCase, x, y, elapsedTime);
+                float multiplier = fixedPointMultiplier(&curve, x, y, elapsedTime);
+                if (reference >= MULTIPLIER_MAX) {
+                    CHECK(multiplier >= MULTIPLIER_MAX * 0.9f);
+                    continue;
+                }
+                // Multipliers close to zero are compared against one fixed-point step.
+                float error = fabsf(multiplier - reference) / fmaxf(reference, 1.0f / 256);
+                if (error > maxRelativeError) {
+                    maxRelativeError = error;
+                }
+                comparisonCount++;
+            }
+        }
+    }
+
+    CHECK(maxRelativeError <= curveCase->maxRelativeError);
+    printf("%s curve: %u speeds, max error %.2f%%, bound %.2f%%\n", curveCase->name, comparisonCount, maxRelativeError * 100, curveCase->maxRelativeError * 100);
+}
+
+static void testMagnitudeError(void)
+{
+    float maxRelativeError = 0;
+
+    for (int32_t x = 0; x <= DELTA_MAX; x++) {
+        for (int32_t y = 1; y <= DELTA_MAX; y++) {
+            int32_t fixedX = x << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+            int32_t fixedY = y << ACCELERATION_CURVE_SPEED_FRACTION_BITS;
+            float exact = sqrt((double)fixedX*fixedX + (double)fixedY*fixedY);
+            float error = fabsf(AccelerationCurve_Magnitude(fixedX, -fixedY) - exact) / exact;
+            if (error > maxRelativeError) {
+                maxRelativeError = error;
+            }
+        }
+    }
+
+    CHECK(maxRelativeError <= 0.015f);
+}
+
+int main(void)
+{
+    testMagnitudeError();
+    for (uint8_t i = 0; i < sizeof(curveCases) / sizeof(curveCases[0]); i++) {
+        testCurveMatchesReference(&curveCases[i]);
+    }
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,292 @@
+#define _GNU_SOURCE // memmem
+#include <time.h>
+#include "test.h"
+#include "config_parser/config_globals.h"
+#include "config_parser/parse_config.h"
+#include "config_parser/parse_keymap.h"
+#include "crc32.h"
+#include "eeprom.h"
+#include "keymap.h"
+#include "layer.h"
+#include "led_display.h"
+#include "macro_events.h"
+#include "macros.h"
+#include "module.h"
+#include "mouse_controller.h"
+#include "peripherals/reset_button.h"
+#include "slave_drivers/is31fl3xxx_driver.h"
+#include "usb_commands/usb_command_apply_config.h"
+#include "usb_protocol_handler.h"
+#include "config_builder.h"
+#include "eeprom_simulator.h"
+
+#define APPLY_REPETITIONS 200
+
+// Stand-ins for the state that applying a config fills in, whose modules aren't built for the host.
+
+static keymap_reference_t keymapReferences[MAX_KEYMAP_NUM] = {
+    {
+        .abbreviation = "FTY",
+        .offset = 0,
+        .abbreviationLen = 3
+    }
+};
+static keymap_reference_t parsedKeymapReferences[MAX_KEYMAP_NUM];
+keymap_reference_t *AllKeymaps = keymapReferences;
+keymap_reference_t *ParsedKeymaps = parsedKeymapReferences;
+uint8_t AllKeymapsCount;
+uint8_t DefaultKeymapIndex;
+uint8_t CurrentKeymapIndex;
+key_action_t CurrentKeymap[LayerId_Count][SLOT_COUNT][MAX_KEY_COUNT_PER_MODULE];
+layer_config_t LayerConfig[LayerId_Count];
+
+static macro_reference_t macroReferences[MacroIndex_MaxCount];
+static macro_reference_t parsedMacroReferences[MacroIndex_MaxCount];
+static macro_action_reference_t macroActionReferences[MAX_MACRO_ACTION_REFERENCE_COUNT];
+static macro_action_reference_t parsedMacroActionReferences[MAX_MACRO_ACTION_REFERENCE_COUNT];
+macro_reference_t *AllMacros = macroReferences;
+macro_reference_t *ParsedMacros = parsedMacroReferences;
+macro_action_reference_t *MacroActionReferences = macroActionReferences;
+macro_action_reference_t *ParsedMacroActionReferences = parsedMacroActionReferences;
+uint8_t AllMacrosCount;
+
+uint8_t IconsAndLayerTextsBrightnessDefault;
+uint8_t AlphanumericSegmentsBrightnessDefault;
+uint8_t KeyBacklightBrightnessDefault;
+mouse_kinetic_state_t MouseMoveState;
+mouse_kinetic_state_t MouseScrollState;
+bool IsFactoryResetModeEnabled;
+
+static uint8_t usbTxBuffer[USB_GENERIC_HID_IN_BUFFER_LENGTH];
+static uint32_t reportedErrorCount;
+
+bool IsModuleAttached(module_id_t moduleId)
+{
+    return moduleId == ModuleId_RightKeyboardHalf || moduleId == ModuleId_LeftKeyboardHalf;
+}
+
+slot_t ModuleIdToSlotId(module_id_t moduleId)
+{
+    return moduleId == ModuleId_LeftKeyboardHalf ? SlotId_LeftKeyboardHalf : SlotId_RightKeyboardHalf;
+}
+
+void LedSlaveDriver_UpdateLeds(void) {}
+void Macros_ClearStatus(void) {}
+void MacroEvent_OnInit(void) {}
+
+void Macros_ReportError(const char* err, const char* arg, const char *argEnd)
+{
+    reportedErrorCount++;
+}
+
+void SetUsbTxBufferUint8(uint32_t offset, uint8_t value)
+{
+    usbTxBuffer[offset] = value;
+}
+
+void SetUsbTxBufferUint16(uint32_t offset, uint16_t value)
+{
+    usbTxBuffer[offset] = value;
+    usbTxBuffer[offset + 1] = value >> 8;
+}
+
+// As in keymap.c, apart from the LED updates.
+void SwitchKeymapById(uint8_t index)
+{
+    CurrentKeymapIndex = index;
+    ValidatedUserConfigBuffer.offset = AllKeymaps[index].offset;
+    ParseKeymap(&ValidatedUserConfigBuffer, index, AllKeymapsCount, AllMacrosCount);
+}
+
+bool SwitchKeymapByAbbreviation(uint8_t length, const char *abbrev)
+{
+    for (uint8_t i = 0; i < AllKeymapsCount; i++) {
+        if (AllKeymaps[i].abbreviationLen == length && memcmp(AllKeymaps[i].abbreviation, abbrev, length) == 0) {
+            SwitchKeymapById(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint8_t config[USER_CONFIG_SIZE];
+
+static double currentSeconds(void)
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Returns the status that the command reports to the host.
+static uint8_t applyConfig(const uint8_t *data, uint16_t length)
+{
+    memcpy(StagingUserConfigBuffer.buffer, data, length);
+    UsbCommand_ApplyConfig();
+    return usbTxBuffer[0];
+}
+
+static void checkAppliedConfig(uint16_t length, uint8_t keymapCount, uint8_t macroCount)
+{
+    CHECK(ValidatedUserConfigLength == length);
+    CHECK(memcmp(ValidatedUserConfigBuffer.buffer, config, length) == 0);
+    if (keymapCount) {
+        CHECK(AllKeymapsCount == keymapCount);
+        CHECK(AllMacrosCount == macroCount);
+    }
+    CHECK(CurrentKeymap[LayerId_Base][SlotId_RightKeyboardHalf][0].type == KeyActionType_Keystroke);
+}
+
+static bool isUserConfigRead;
+static bool isHardwareConfigRead;
+
+static void hardwareConfigurationReadFinished(void)
+{
+    isHardwareConfigRead = true;
+}
+
+static void userConfigurationReadFinished(void)
+{
+    isUserConfigRead = true;
+    EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_HardwareConfig, hardwareConfigurationReadFinished);
+}
+
+// The main loop applies the user config at boot while the hardware config is still being read.
+static void testBootAppliesSavedConfig(void)
+{
+    uint16_t length = ConfigBuilder_Build(config, USER_CONFIG_SIZE, 5, 2, 3);
+
+    memset(SimulatedEepromMemory, 0xff, sizeof SimulatedEepromMemory);
+    memcpy(SimulatedEepromMemory + HARDWARE_CONFIG_SIZE, config, length);
+
+    CHECK(EEPROM_LaunchTransfer(EepromOperation_Read, ConfigBufferId_StagingUserConfig, userConfigurationReadFinished) == kStatus_Success);
+    while (!isUserConfigRead && EepromSimulator_Step()) {
+    }
+    CHECK(isUserConfigRead && IsEepromBusy);
+
+    UsbCommand_ApplyConfig();
+    CHECK(usbTxBuffer[0] == UsbStatusCode_Success);
+    checkAppliedConfig(length, 2, 3);
+
+    EepromSimulator_Run();
+    CHECK(isHardwareConfigRead);
+}
+
+// Applying waits for saves, which read from the config buffers until their last page is out.
+static void testApplyIsRejectedWhileSaving(void)
+{
+    uint16_t length = ConfigBuilder_Build(config, USER_CONFIG_SIZE, 6, 2, 3);
+    uint8_t otherConfig[USER_CONFIG_SIZE];
+    uint16_t otherLength = ConfigBuilder_Build(otherConfig, USER_CONFIG_SIZE, 9, 3, 4);
+
+    HardwareConfigBuffer.buffer[HARDWARE_CONFIG_SIZE - 1]++;
+    CHECK(EEPROM_LaunchTransfer(EepromOperation_Write, ConfigBufferId_HardwareConfig, NULL) == kStatus_Success);
+    CHECK(IsEepromWriteInProgress());
+    uint8_t *validatedBuffer = ValidatedUserConfigBuffer.buffer;
+    CHECK(applyConfig(otherConfig, otherLength) == UsbStatusCode_ApplyConfig_EepromBusy);
+    CHECK(ValidatedUserConfigBuffer.buffer == validatedBuffer);
+    CHECK(AllKeymapsCount == 2);
+
+    EepromSimulator_Run();
+    CHECK(applyConfig(config, length) == UsbStatusCode_Success);
+    checkAppliedConfig(length, 2, 3);
+}
+
+// A config that fails validation mustn't change anything that is running.
+static void testFailedValidationKeepsRunningConfig(void)
+{
+    uint16_t length = ConfigBuilder_Build(config, USER_CONFIG_SIZE, 7, 3, 5);
+    CHECK(applyConfig(config, length) == UsbStatusCode_Success);
+
+    uint8_t *validatedBuffer = ValidatedUserConfigBuffer.buffer;
+    keymap_reference_t *keymaps = AllKeymaps;
+    key_action_t keymap[LayerId_Count][SLOT_COUNT][MAX_KEY_COUNT_PER_MODULE];
+    memcpy(keymap, CurrentKeymap, sizeof keymap);
+
+    // The abbreviation of the last keymap gets too long, after everything else has been parsed.
+    uint8_t invalidConfig[USER_CONFIG_SIZE];
+    uint16_t invalidLength = ConfigBuilder_Build(invalidConfig, USER_CONFIG_SIZE, 8, 4, 5);
+    uint8_t *abbreviation = memmem(invalidConfig, invalidLength, "\x03K03", 4);
+    CHECK(abbreviation != NULL);
+    abbreviation[0] = KEYMAP_ABBREVIATION_LENGTH + 1;
+    CHECK(applyConfig(invalidConfig, invalidLength) == ParserError_InvalidAbbreviationLen);
+
+    CHECK(ValidatedUserConfigBuffer.buffer == validatedBuffer);
+    CHECK(ValidatedUserConfigLength == length);
+    CHECK(AllKeymaps == keymaps);
+    CHECK(AllKeymapsCount == 3);
+    CHECK(AllMacrosCount == 5);
+    CHECK(memcmp(keymap, CurrentKeymap, sizeof keymap) == 0);
+}
+
+// The config hash tells Agent which config is running, so only configs that get to run change it.
+static void testConfigHashFollowsRunningConfig(void)
+{
+    uint16_t length = ConfigBuilder_Build(config, USER_CONFIG_SIZE, 10, 2, 2);
+    uint32_t crc = CRC32_Update(CRC32_INITIAL_VALUE, config, length);
+    CHECK(applyConfig(config, length) == UsbStatusCode_Success);
+    CHECK(ValidatedUserConfigCrc == crc && ValidatedUserConfigCrcLength == length);
+
+    uint8_t otherConfig[USER_CONFIG_SIZE];
+    uint16_t otherLength = ConfigBuilder_Build(otherConfig, USER_CONFIG_SIZE, 11, 3, 1);
+    IsFactoryResetModeEnabled = true;
+    CHECK(applyConfig(otherConfig, otherLength) == UsbStatusCode_Success);
+    IsFactoryResetModeEnabled = false;
+    CHECK(ValidatedUserConfigCrc == crc && ValidatedUserConfigCrcLength == length);
+    CHECK(AllKeymapsCount == 2);
+
+    CHECK(applyConfig(otherConfig, otherLength) == UsbStatusCode_Success);
+    CHECK(ValidatedUserConfigCrc == CRC32_Update(CRC32_INITIAL_VALUE, otherConfig, otherLength));
+    CHECK(ValidatedUserConfigCrcLength == otherLength);
+}
+
+static void benchmarkConfig(const char *name, uint16_t length, uint8_t keymapCount, uint8_t macroCount)
+{
+    double applySeconds = 0;
+
+    for (uint16_t i = 0; i < APPLY_REPETITIONS; i++) {
+        memcpy(StagingUserConfigBuffer.buffer, config, length);
+        double start = currentSeconds();
+        UsbCommand_ApplyConfig();
+        applySeconds += currentSeconds() - start;
+        CHECK(usbTxBuffer[0] == UsbStatusCode_Success);
+    }
+
+    checkAppliedConfig(length, keymapCount, macroCount);
+    printf("%s: %u bytes, applied in %.1f us\n", name, length, applySeconds / APPLY_REPETITIONS * 1e6);
+}
+
+// Configs saved by Agent can be passed as arguments, built ones are measured anyway.
+static void benchmarkConfigs(int argc, char **argv)
+{
+    static const uint8_t shapes[][2] = {{1, 0}, {4, 10}, {8, 40}, {12, 100}};
+    char name[64];
+
+    for (uint8_t i = 0; i < sizeof shapes / sizeof shapes[0]; i++) {
+        uint16_t length = ConfigBuilder_Build(config, USER_CONFIG_SIZE, i, shapes[i][0], shapes[i][1]);
+        snprintf(name, sizeof name, "%u keymaps, %u macros", shapes[i][0], shapes[i][1]);
+        benchmarkConfig(name, length, shapes[i][0], shapes[i][1]);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        CHECK(file != NULL);
+        if (file) {
+            uint16_t length = fread(config, 1, USER_CONFIG_SIZE, file);
+            fclose(file);
+            benchmarkConfig(argv[i], length, 0, 0);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    EEPROM_Init();
+    testBootAppliesSavedConfig();
+    testApplyIsRejectedWhileSaving();
+    testFailedValidationKeepsRunningConfig();
+    testConfigHashFollowsRunningConfig();
+    benchmarkConfigs(argc, argv);
+    CHECK(reportedErrorCount == 0);
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,264 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "config_builder.h"
+
+#define DATA_MODEL_MAJOR_VERSION 5
+#define DATA_MODEL_MINOR_VERSION 1
+#define USER_CONFIG_LENGTH_OFFSET 6
+
+#define KEY_COUNT_PER_HALF 35
+#define MODULE_CONFIGURATION_COUNT 3
+#define MODULE_CONFIGURATION_LENGTH 9 // Following the module id
+
+// Serialized key action types, see parse_keymap.h.
+#define KEY_ACTION_NONE 0
+#define KEY_ACTION_KEYSTROKE 1
+#define KEY_ACTION_KEYSTROKE_HAS_MODIFIERS 0b00010
+#define KEY_ACTION_KEYSTROKE_HAS_LONGPRESS 0b00100
+#define KEY_ACTION_KEYSTROKE_LONG_MEDIA (2 << 3)
+#define KEY_ACTION_SWITCH_LAYER 32
+#define KEY_ACTION_SWITCH_KEYMAP 33
+#define KEY_ACTION_MOUSE 34
+#define KEY_ACTION_PLAY_MACRO 35
+
+// Serialized macro action types, see parse_macro.h.
+#define MACRO_ACTION_KEY_HAS_SCANCODE (0b10 << 4)
+#define MACRO_ACTION_KEY_HAS_MODIFIERS (0b01 << 4)
+#define MACRO_ACTION_DELAY 69
+#define MACRO_ACTION_TEXT 70
+#define MACRO_ACTION_COMMAND 71
+
+#define LAYER_ID_BASE 255
+
+typedef struct {
+    uint8_t *buffer;
+    uint16_t capacity;
+    uint16_t offset;
+    bool hasOverflown;
+} writer_t;
+
+static uint32_t randomState;
+
+static uint32_t randomNumber(uint32_t limit)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return (randomState >> 16) % limit;
+}
+
+static void writeUint8(writer_t *writer, uint8_t value)
+{
+    if (writer->offset >= writer->capacity) {
+        writer->hasOverflown = true;
+        return;
+    }
+    writer->buffer[writer->offset++] = value;
+}
+
+static void writeUint16(writer_t *writer, uint16_t value)
+{
+    writeUint8(writer, value);
+    writeUint8(writer, value >> 8);
+}
+
+static void writeCompactLength(writer_t *writer, uint16_t length)
+{
+    if (length < 0xff) {
+        writeUint8(writer, length);
+    } else {
+        writeUint8(writer, 0xff);
+        writeUint16(writer, length);
+    }
+}
+
+static void writeString(writer_t *writer, const char *string)
+{
+    uint16_t length = strlen(string);
+
+    writeCompactLength(writer, length);
+    for (uint16_t i = 0; i < length; i++) {
+        writeUint8(writer, string[i]);
+    }
+}
+
+static void writeKeystroke(writer_t *writer, uint8_t scancode, uint8_t modifiers)
+{
+    writeUint8(writer, KEY_ACTION_KEYSTROKE | (modifiers ? KEY_ACTION_KEYSTROKE_HAS_MODIFIERS : 0));
+    writeUint8(writer, scancode);
+    if (modifiers) {
+        writeUint8(writer, modifiers);
+    }
+}
+
+// Base layers are letters and the like, with a few dual role keys and layer switches.
+static void writeBaseKeyAction(writer_t *writer, uint8_t keyIndex)
+{
+    if (keyIndex == 30) {
+        writeUint8(writer, KEY_ACTION_SWITCH_LAYER);
+        writeUint8(writer, 0);
+        writeUint8(writer, 0);
+    } else if (keyIndex == 31) {
+        writeUint8(writer, KEY_ACTION_SWITCH_LAYER);
+        writeUint8(writer, 1);
+        writeUint8(writer, 0);
+    } else if (keyIndex == 32) {
+        writeUint8(writer, KEY_ACTION_KEYSTROKE | KEY_ACTION_KEYSTROKE_HAS_LONGPRESS);
+        writeUint8(writer, 0x2c);
+        writeUint8(writer, 1);
+    } else if (keyIndex == 34) {
+        writeUint8(writer, KEY_ACTION_NONE);
+    } else {
+        writeKeystroke(writer, 4 + (keyIndex * 7 + randomNumber(3)) % 50, randomNumber(16) ? 0 : 1 << randomNumber(8));
+    }
+}
+
+static void writeKeyAction(writer_t *writer, uint8_t layerIndex, uint8_t keyIndex, uint8_t keymapCount, uint8_t macroCount)
+{
+    if (layerIndex == 0) {
+        writeBaseKeyAction(writer, keyIndex);
+        return;
+    }
+
+    switch (randomNumber(8)) {
+        case 0:
+        case 1:
+            writeKeystroke(writer, 0x3a + randomNumber(12), 0);
+            break;
+        case 2:
+            writeUint8(writer, KEY_ACTION_KEYSTROKE | KEY_ACTION_KEYSTROKE_LONG_MEDIA);
+            writeUint16(writer, 0xe2 + randomNumber(16));
+            break;
+        case 3:
+            if (layerIndex == 3) {
+                writeUint8(writer, KEY_ACTION_MOUSE);
+                writeUint8(writer, randomNumber(18));
+            } else if (macroCount) {
+                writeUint8(writer, KEY_ACTION_PLAY_MACRO);
+                writeUint8(writer, randomNumber(macroCount));
+            } else {
+                writeUint8(writer, KEY_ACTION_SWITCH_KEYMAP);
+                writeUint8(writer, randomNumber(keymapCount));
+            }
+            break;
+        default:
+            writeUint8(writer, KEY_ACTION_NONE);
+            break;
+    }
+}
+
+static void writeKeymap(writer_t *writer, uint8_t keymapIndex, uint8_t keymapCount, uint8_t macroCount)
+{
+    static const uint8_t layerIds[] = {LAYER_ID_BASE, 0, 1, 2};
+    char text[64];
+
+    snprintf(text, sizeof text, "K%02u", keymapIndex);
+    writeString(writer, text);
+    writeUint8(writer, keymapIndex == 0);
+    snprintf(text, sizeof text, "Keymap %u", keymapIndex);
+    writeString(writer, text);
+    writeString(writer, "A keymap that has been built for the host tests.");
+
+    writeCompactLength(writer, sizeof layerIds);
+    for (uint8_t layerIndex = 0; layerIndex < sizeof layerIds; layerIndex++) {
+        writeUint8(writer, layerIds[layerIndex]);
+        writeCompactLength(writer, 2);
+        for (uint8_t moduleId = 0; moduleId < 2; moduleId++) {
+            writeUint8(writer, moduleId);
+            writeCompactLength(writer, KEY_COUNT_PER_HALF);
+            for (uint8_t keyIndex = 0; keyIndex < KEY_COUNT_PER_HALF; keyIndex++) {
+                writeKeyAction(writer, layerIndex, keyIndex, keymapCount, macroCount);
+            }
+        }
+    }
+}
+
+static void writeMacroAction(writer_t *writer, uint8_t actionIndex)
+{
+    switch (randomNumber(6)) {
+        case 0:
+            writeUint8(writer, MACRO_ACTION_TEXT);
+            writeString(writer, actionIndex % 2 ? "Kind regards,\n" : "Hello world!");
+            break;
+        case 1:
+            writeUint8(writer, MACRO_ACTION_DELAY);
+            writeUint16(writer, 50 * (1 + randomNumber(10)));
+            break;
+        case 2:
+            writeUint8(writer, MACRO_ACTION_COMMAND);
+            writeString(writer, "ifShortcut 91 92 final tapKey C-c\nholdKey LS-a\n");
+            break;
+        default:
+            // Press, hold or release of a basic scancode, with modifiers every now and then.
+            if (randomNumber(4)) {
+                writeUint8(writer, MACRO_ACTION_KEY_HAS_SCANCODE | randomNumber(3));
+                writeUint8(writer, 4 + randomNumber(40));
+            } else {
+                writeUint8(writer, MACRO_ACTION_KEY_HAS_SCANCODE | MACRO_ACTION_KEY_HAS_MODIFIERS | randomNumber(3));
+                writeUint8(writer, 4 + randomNumber(40));
+                writeUint8(writer, 1 << randomNumber(8));
+            }
+            break;
+    }
+}
+
+static void writeMacro(writer_t *writer, uint8_t macroIndex)
+{
+    char name[32];
+    uint8_t actionCount = 1 + randomNumber(12);
+
+    writeUint8(writer, false);
+    writeUint8(writer, false);
+    snprintf(name, sizeof name, "Macro %u", macroIndex);
+    writeString(writer, name);
+    writeCompactLength(writer, actionCount);
+    for (uint8_t actionIndex = 0; actionIndex < actionCount; actionIndex++) {
+        writeMacroAction(writer, actionIndex);
+    }
+}
+
+uint16_t ConfigBuilder_Build(uint8_t *buffer, uint16_t capacity, uint32_t seed, uint8_t keymapCount, uint8_t macroCount)
+{
+    static const uint8_t mouseKineticProperties[] = {5, 35, 10, 40, 80, 20, 20, 10, 20, 50};
+    writer_t writer = {.buffer = buffer, .capacity = capacity};
+
+    randomState = seed;
+
+    writeUint16(&writer, DATA_MODEL_MAJOR_VERSION);
+    writeUint16(&writer, DATA_MODEL_MINOR_VERSION);
+    writeUint16(&writer, 0);
+    writeUint16(&writer, 0);
+    writeString(&writer, "My UHK");
+    writeUint16(&writer, 250);
+
+    for (uint8_t i = 0; i < 3; i++) {
+        writeUint8(&writer, 255);
+    }
+    for (uint8_t i = 0; i < sizeof mouseKineticProperties; i++) {
+        writeUint8(&writer, mouseKineticProperties[i]);
+    }
+
+    writeCompactLength(&writer, MODULE_CONFIGURATION_COUNT);
+    for (uint8_t moduleIndex = 0; moduleIndex < MODULE_CONFIGURATION_COUNT; moduleIndex++) {
+        writeUint8(&writer, 2 + moduleIndex);
+        for (uint8_t i = 0; i < MODULE_CONFIGURATION_LENGTH; i++) {
+            writeUint8(&writer, 1);
+        }
+    }
+
+    writeCompactLength(&writer, macroCount);
+    for (uint8_t macroIndex = 0; macroIndex < macroCount; macroIndex++) {
+        writeMacro(&writer, macroIndex);
+    }
+
+    writeCompactLength(&writer, keymapCount);
+    for (uint8_t keymapIndex = 0; keymapIndex < keymapCount; keymapIndex++) {
+        writeKeymap(&writer, keymapIndex, keymapCount, macroCount);
+    }
+
+    if (writer.hasOverflown) {
+        return 0;
+    }
+    buffer[USER_CONFIG_LENGTH_OFFSET] = writer.offset;
+    buffer[USER_CONFIG_LENGTH_OFFSET + 1] = writer.offset >> 8;
+    return writer.offset;
+}
@@ -0,0 +1,15 @@
+#ifndef __CONFIG_BUILDER_H__
+#define __CONFIG_BUILDER_H__
+
+// Includes:
+
+    #include <stdint.h>
+
+// Functions:
+
+    // Serializes a user config in the format that the config parser reads, laid out like the ones
+    // that Agent saves: keymaps with base, mod, fn and mouse layers over both keyboard halves, and
+    // macros of key, text, delay and command actions. Returns the length, or 0 if it doesn't fit.
+    uint16_t ConfigBuilder_Build(uint8_t *buffer, uint16_t capacity, uint32_t seed, uint8_t keymapCount, uint8_t macroCount);
+
+#endif
@@ -0,0 +1,122 @@
+#include <assert.h>
+#include "fsl_pit.h"
+#include "i2c.h"
+#include "i2c_addresses.h"
+#include "buffer.h"
+#include "peripherals/pit.h"
+#include "eeprom_simulator.h"
+
+uint8_t SimulatedEepromMemory[EEPROM_SIZE];
+uint32_t SimulatedEepromPageWrites;
+uint32_t SimulatedEepromWriteCycleTime = SIMULATED_EEPROM_WRITE_CYCLE_TIME_USEC;
+uint32_t SimulatedEepromWriteCycleEnd;
+
+static uint16_t deviceAddress;
+
+static uint32_t currentTime;
+static uint32_t timerPeriod;
+static bool isTimerRunning;
+
+static i2c_master_edma_transfer_callback_t i2cCallback;
+static i2c_master_edma_handle_t *i2cHandle;
+static bool isTransferPending;
+static status_t pendingTransferStatus;
+
+uint32_t CLOCK_GetFreq(clock_name_t clockName)
+{
+    return 1000000;
+}
+
+void PIT_GetDefaultConfig(pit_config_t *config) {}
+void PIT_Init(PIT_Type *base, const pit_config_t *config) {}
+void PIT_EnableInterrupts(PIT_Type *base, pit_chnl_t channel, uint32_t mask) {}
+void PIT_ClearStatusFlags(PIT_Type *base, pit_chnl_t channel, uint32_t mask) {}
+
+void PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t channel, uint32_t count)
+{
+    timerPeriod = count;
+}
+
+void PIT_StartTimer(PIT_Type *base, pit_chnl_t channel)
+{
+    isTimerRunning = true;
+}
+
+void PIT_StopTimer(PIT_Type *base, pit_chnl_t channel)
+{
+    isTimerRunning = false;
+}
+
+void PIT_EEPROM_HANDLER(void);
+
+void I2C_MasterTransferCreateHandle(I2C_Type *base, i2c_master_handle_t *handle, i2c_master_transfer_callback_t callback, void *userData) {}
+
+void I2cInitDma(I2C_Type *base, uint8_t dmaChannel, dma_request_source_t dmaRequest, edma_handle_t *edmaHandle, i2c_master_edma_handle_t *handle, i2c_master_edma_transfer_callback_t callback)
+{
+    i2cHandle = handle;
+    i2cCallback = callback;
+}
+
+static void deviceWrite(const uint8_t *data, size_t dataSize)
+{
+    deviceAddress = GetBufferUint16Be(data, 0) % EEPROM_SIZE;
+    if (dataSize == EEPROM_ADDRESS_SIZE) {
+        return;
+    }
+
+    // Writes wrap around within the page.
+    uint16_t pageStart = deviceAddress - deviceAddress % EEPROM_PAGE_SIZE;
+    for (size_t i = EEPROM_ADDRESS_SIZE; i < dataSize; i++) {
+        SimulatedEepromMemory[pageStart + (deviceAddress - pageStart + i - EEPROM_ADDRESS_SIZE) % EEPROM_PAGE_SIZE] = data[i];
+    }
+    SimulatedEepromPageWrites++;
+    SimulatedEepromWriteCycleEnd = currentTime + SimulatedEepromWriteCycleTime;
+}
+
+static void deviceRead(uint8_t *data, size_t dataSize)
+{
+    for (size_t i = 0; i < dataSize; i++) {
+        data[i] = SimulatedEepromMemory[deviceAddress];
+        deviceAddress = (deviceAddress + 1) % EEPROM_SIZE;
+    }
+}
+
+status_t I2cTransferDma(I2C_Type *base, i2c_master_edma_handle_t *edmaHandle, i2c_master_handle_t *handle, i2c_master_transfer_t *transfer)
+{
+    assert(!isTransferPending);
+    assert(transfer->slaveAddress == I2C_ADDRESS_EEPROM);
+
+    isTransferPending = true;
+    if (currentTime < SimulatedEepromWriteCycleEnd) {
+        pendingTransferStatus = kStatus_I2C_Addr_Nak;
+        return kStatus_Success;
+    }
+
+    pendingTransferStatus = kStatus_Success;
+    if (transfer->direction == kI2C_Write) {
+        deviceWrite(transfer->data, transfer->dataSize);
+    } else {
+        deviceRead(transfer->data, transfer->dataSize);
+    }
+    return kStatus_Success;
+}
+
+bool EepromSimulator_Step(void)
+{
+    if (isTransferPending) {
+        isTransferPending = false;
+        i2cCallback(I2C_EEPROM_BUS_BASEADDR, i2cHandle, pendingTransferStatus, NULL);
+    } else if (isTimerRunning) {
+        currentTime += timerPeriod;
+        PIT_EEPROM_HANDLER();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void EepromSimulator_Run(void)
+{
+    while (EepromSimulator_Step()) {
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef __EEPROM_SIMULATOR_H__
+#define __EEPROM_SIMULATOR_H__
+
+// Includes:
+
+    #include "eeprom.h"
+
+// Macros:
+
+    #define SIMULATED_EEPROM_WRITE_CYCLE_TIME_USEC 5000
+
+// Variables:
+
+    // A simulated 24C256 behind the EEPROM driver, which doesn't acknowledge its address until its
+    // write cycle is over.
+    extern uint8_t SimulatedEepromMemory[EEPROM_SIZE];
+    extern uint32_t SimulatedEepromPageWrites;
+    extern uint32_t SimulatedEepromWriteCycleTime;
+    extern uint32_t SimulatedEepromWriteCycleEnd;
+
+// Functions:
+
+    // Delivers the next transfer completion or timer interrupt. Returns false if there is none.
+    bool EepromSimulator_Step(void);
+
+    // Steps until the EEPROM driver has nothing left to do.
+    void EepromSimulator_Run(void);
+
+#endif
@@ -0,0 +1,176 @@
+#include "test.h"
+#include "eeprom.h"
+#include "buffer.h"
+#include "config_builder.h"
+#include "eeprom_simulator.h"
+
+static uint32_t successCallbackCount;
+
+static void onSuccess(void)
+{
+    successCallbackCount++;
+}
+
+static void runTransfer(eeprom_operation_t operation, config_buffer_id_t configBufferId)
+{
+    CHECK(EEPROM_LaunchTransfer(operation, configBufferId, onSuccess) == kStatus_Success);
+    EepromSimulator_Run();
+    CHECK(!IsEepromBusy);
+}
+
+// Random data doesn't compress, so the config gets stored as it is.
+static void fillRandomUserConfig(uint8_t *buffer, uint16_t length)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        buffer[i] = rand();
+    }
+    SetBufferUint16(buffer, 0, 5);
+    SetBufferUint16(buffer, USER_CONFIG_LENGTH_OFFSET, length);
+}
+
+static uint32_t writeValidatedUserConfig(uint16_t length)
+{
+    uint32_t pageWrites = SimulatedEepromPageWrites;
+    uint32_t successCallbacks = successCallbackCount;
+
+    ValidatedUserConfigLength = length;
+    runTransfer(EepromOperation_Write, ConfigBufferId_ValidatedUserConfig);
+
+    CHECK(successCallbackCount == successCallbacks + 1);
+    CHECK(memcmp(SimulatedEepromMemory + HARDWARE_CONFIG_SIZE, ValidatedUserConfigBuffer.buffer, length) == 0);
+    return SimulatedEepromPageWrites - pageWrites;
+}
+
+// The checksums of the read pages are known after booting, so saving the same config again
+// doesn't write anything.
+static void testUnchangedConfigIsNotWritten(void)
+{
+    uint16_t length = 50 * EEPROM_PAGE_SIZE;
+
+    memset(SimulatedEepromMemory, 0xff, sizeof SimulatedEepromMemory);
+    fillRandomUserConfig(SimulatedEepromMemory + HARDWARE_CONFIG_SIZE, length);
+
+    runTransfer(EepromOperation_Read, ConfigBufferId_HardwareConfig);
+    runTransfer(EepromOperation_Read, ConfigBufferId_ValidatedUserConfig);
+    CHECK(memcmp(SimulatedEepromMemory + HARDWARE_CONFIG_SIZE, ValidatedUserConfigBuffer.buffer, length) == 0);
+
+    CHECK(writeValidatedUserConfig(length) == 0);
+
+    uint32_t pageWrites = SimulatedEepromPageWrites;
+    runTransfer(EepromOperation_Write, ConfigBufferId_HardwareConfig);
+    CHECK(SimulatedEepromPageWrites == pageWrites);
+}
+
+static void testOnlyChangedPagesAreWritten(void)
+{
+    uint16_t length = 50 * EEPROM_PAGE_SIZE;
+
+    ValidatedUserConfigBuffer.buffer[1000]++;
+    ValidatedUserConfigBuffer.buffer[1001]++;
+    ValidatedUserConfigBuffer.buffer[2500]++;
+    CHECK(writeValidatedUserConfig(length) == 2);
+
+    // Written pages are known as well.
+    CHECK(writeValidatedUserConfig(length) == 0);
+
+    ValidatedUserConfigBuffer.buffer[0]++;
+    ValidatedUserConfigBuffer.buffer[length - 1]++;
+    CHECK(writeValidatedUserConfig(length) == 2);
+
+    uint32_t pageWrites = SimulatedEepromPageWrites;
+    HardwareConfigBuffer.buffer[HARDWARE_CONFIG_SIZE - 1]++;
+    runTransfer(EepromOperation_Write, ConfigBufferId_HardwareConfig);
+    CHECK(SimulatedEepromPageWrites == pageWrites + 1);
+    CHECK(memcmp(SimulatedEepromMemory, HardwareConfigBuffer.buffer, HARDWARE_CONFIG_SIZE) == 0);
+}
+
+// A page that is written only in part isn't hashed, so it gets written every time.
+static void testPartialPageIsWritten(void)
+{
+    uint16_t length = 20 * EEPROM_PAGE_SIZE + 10;
+
+    SetBufferUint16(ValidatedUserConfigBuffer.buffer, USER_CONFIG_LENGTH_OFFSET, length);
+    CHECK(writeValidatedUserConfig(length) == 2);
+    CHECK(writeValidatedUserConfig(length) == 1);
+}
+
+static void testBusyDeviceIsPolled(void)
+{
+    uint16_t length = 30 * EEPROM_PAGE_SIZE;
+    uint32_t pollCount = EepromWritePollCounter;
+
+    SimulatedEepromWriteCycleTime = EEPROM_WRITE_CYCLE_TIME_USEC + 2 * EEPROM_POLL_INTERVAL_USEC;
+    fillRandomUserConfig(ValidatedUserConfigBuffer.buffer, length);
+    CHECK(writeValidatedUserConfig(length) == 30);
+    CHECK(EepromWritePollCounter == pollCount + 29 * 2);
+    CHECK(!HasEepromWriteFailed);
+    SimulatedEepromWriteCycleTime = SIMULATED_EEPROM_WRITE_CYCLE_TIME_USEC;
+}
+
+static void testUnresponsiveDeviceFailsTheWrite(void)
+{
+    uint16_t length = 30 * EEPROM_PAGE_SIZE;
+    uint32_t failureCount = EepromWriteFailureCounter;
+    uint32_t successCallbacks = successCallbackCount;
+
+    ValidatedUserConfigBuffer.buffer[100]++;
+    ValidatedUserConfigLength = length;
+    SimulatedEepromWriteCycleEnd = UINT32_MAX;
+    runTransfer(EepromOperation_Write, ConfigBufferId_ValidatedUserConfig);
+    CHECK(HasEepromWriteFailed);
+    CHECK(EepromWriteFailureCounter == failureCount + 1);
+    CHECK(successCallbackCount == successCallbacks);
+
+    // The page that didn't make it isn't assumed to be written.
+    SimulatedEepromWriteCycleEnd = 0;
+    CHECK(writeValidatedUserConfig(length) == 1);
+    CHECK(!HasEepromWriteFailed);
+}
+
+// Older firmwares can't read compressed configs, so they are stored as they are unless asked for.
+static void testConfigIsNotCompressedByDefault(void)
+{
+    uint16_t length = ConfigBuilder_Build(ValidatedUserConfigBuffer.buffer, USER_CONFIG_SIZE, 1, 8, 40);
+
+    ValidatedUserConfigLength = length;
+    runTransfer(EepromOperation_Write, ConfigBufferId_ValidatedUserConfig);
+
+    CHECK(memcmp(SimulatedEepromMemory + HARDWARE_CONFIG_SIZE, ValidatedUserConfigBuffer.buffer, length) == 0);
+}
+
+// Configs that compress get stored compressed when asked for, and come back as they were.
+static void testCompressedConfigRoundTrip(void)
+{
+    uint16_t length = ConfigBuilder_Build(ValidatedUserConfigBuffer.buffer, USER_CONFIG_SIZE, 1, 8, 40);
+    uint32_t pageWrites = SimulatedEepromPageWrites;
+
+    ValidatedUserConfigLength = length;
+    IsUserConfigCompressionRequested = true;
+    runTransfer(EepromOperation_Write, ConfigBufferId_ValidatedUserConfig);
+    IsUserConfigCompressionRequested = false;
+
+    uint8_t *storedConfig = SimulatedEepromMemory + HARDWARE_CONFIG_SIZE;
+    uint16_t storedLength = GetBufferUint16(storedConfig, USER_CONFIG_LENGTH_OFFSET);
+    CHECK(GetBufferUint16(storedConfig, 0) == USER_CONFIG_COMPRESSED_MARKER);
+    CHECK(GetBufferUint16(storedConfig, USER_CONFIG_UNCOMPRESSED_LENGTH_OFFSET) == length);
+    CHECK(storedLength < length);
+    uint32_t storedPageCount = (storedLength + EEPROM_PAGE_SIZE - 1) / EEPROM_PAGE_SIZE;
+    CHECK(SimulatedEepromPageWrites - pageWrites <= storedPageCount);
+
+    memset(StagingUserConfigBuffer.buffer, 0, USER_CONFIG_SIZE);
+    runTransfer(EepromOperation_Read, ConfigBufferId_StagingUserConfig);
+    CHECK(memcmp(StagingUserConfigBuffer.buffer, ValidatedUserConfigBuffer.buffer, length) == 0);
+}
+
+int main(void)
+{
+    EEPROM_Init();
+    testUnchangedConfigIsNotWritten();
+    testOnlyChangedPagesAreWritten();
+    testPartialPageIsWritten();
+    testBusyDeviceIsPolled();
+    testUnresponsiveDeviceFailsTheWrite();
+    testConfigIsNotCompressedByDefault();
+    testCompressedConfigRoundTrip();
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,180 @@
+#include <time.h>
+#include "test.h"
+#include "fsl_common.h"
+#include "lz4.h"
+#include "eeprom.h"
+#include "config_builder.h"
+
+#define GUARD_SIZE 64
+#define GUARD_VALUE 0xa5
+#define DECODE_REPETITIONS 200
+
+static uint8_t source[USER_CONFIG_SIZE];
+static uint8_t compressed[USER_CONFIG_SIZE];
+static uint8_t decompressed[USER_CONFIG_SIZE + GUARD_SIZE];
+
+static uint32_t randomState = 1;
+
+static uint32_t randomNumber(uint32_t limit)
+{
+    randomState = randomState * 1103515245 + 12345;
+    return (randomState >> 16) % limit;
+}
+
+// Checks both a separate destination and the in place layout that the EEPROM driver uses, where
+// the compressed data sits at the end of the buffer that it gets decompressed into.
+static uint16_t checkRoundTrip(const uint8_t *data, uint16_t length)
+{
+    uint16_t inPlaceMargin;
+    uint16_t compressedLength = LZ4_Compress(data, length, compressed, USER_CONFIG_SIZE, &inPlaceMargin);
+
+    CHECK(compressedLength != 0);
+    if (compressedLength == 0) {
+        return 0;
+    }
+
+    memset(decompressed, GUARD_VALUE, sizeof decompressed);
+    CHECK(LZ4_Decompress(compressed, compressedLength, decompressed, USER_CONFIG_SIZE) == length);
+    CHECK(memcmp(decompressed, data, length) == 0);
+
+    // Configs that would need a larger buffer get stored uncompressed.
+    uint32_t bufferSize = compressedLength + inPlaceMargin;
+    CHECK(bufferSize >= length);
+    if (bufferSize > USER_CONFIG_SIZE) {
+        return compressedLength;
+    }
+    memset(decompressed, GUARD_VALUE, sizeof decompressed);
+    memcpy(decompressed + bufferSize - compressedLength, compressed, compressedLength);
+    CHECK(LZ4_Decompress(decompressed + bufferSize - compressedLength, compressedLength, decompressed, bufferSize) == length);
+    CHECK(memcmp(decompressed, data, length) == 0);
+    CHECK(decompressed[bufferSize] == GUARD_VALUE);
+
+    return compressedLength;
+}
+
+static void fillPattern(uint8_t *data, uint16_t length, uint8_t pattern)
+{
+    for (uint16_t i = 0; i < length; i++) {
+        switch (pattern) {
+            case 0:
+                data[i] = randomNumber(256);
+                break;
+            case 1:
+                data[i] = randomNumber(4);
+                break;
+            case 2:
+                data[i] = i > 50 && randomNumber(8) ? data[i - 1 - randomNumber(40)] : randomNumber(256);
+                break;
+            default:
+                data[i] = i < 300 ? 0 : data[i - 300];
+                break;
+        }
+    }
+}
+
+static void testRoundTrips(void)
+{
+    for (uint16_t length = 1; length < 300; length++) {
+        fillPattern(source, length, length % 4);
+        checkRoundTrip(source, length);
+    }
+
+    for (uint16_t iteration = 0; iteration < 400; iteration++) {
+        uint16_t length = 1 + randomNumber(USER_CONFIG_SIZE);
+        fillPattern(source, length, iteration % 4);
+        checkRoundTrip(source, length);
+    }
+
+    // Matches and literal runs whose lengths need extension bytes.
+    memset(source, 'x', USER_CONFIG_SIZE);
+    CHECK(checkRoundTrip(source, USER_CONFIG_SIZE) < 200);
+    fillPattern(source, 1000, 0);
+    checkRoundTrip(source, USER_CONFIG_SIZE);
+}
+
+static void testSmallDestinations(void)
+{
+    uint16_t inPlaceMargin;
+
+    fillPattern(source, 4000, 0);
+    CHECK(LZ4_Compress(source, 4000, compressed, 4000, &inPlaceMargin) == 0);
+
+    fillPattern(source, 4000, 2);
+    uint16_t compressedLength = LZ4_Compress(source, 4000, compressed, USER_CONFIG_SIZE, &inPlaceMargin);
+    CHECK(LZ4_Compress(source, 4000, compressed, compressedLength - 1, &inPlaceMargin) == 0);
+
+    memset(decompressed, GUARD_VALUE, sizeof decompressed);
+    CHECK(LZ4_Decompress(compressed, compressedLength, decompressed, 3999) == 0);
+    CHECK(decompressed[3999] == GUARD_VALUE);
+}
+
+// Whatever the EEPROM holds, decompression must stay within its buffers.
+static void testCorruptedInput(void)
+{
+    for (uint32_t iteration = 0; iteration < 100000; iteration++) {
+        uint16_t length = randomNumber(200);
+        uint16_t capacity = randomNumber(USER_CONFIG_SIZE);
+        for (uint16_t i = 0; i < length; i++) {
+            compressed[i] = randomNumber(256);
+        }
+        memset(decompressed + capacity, GUARD_VALUE, GUARD_SIZE);
+        CHECK(LZ4_Decompress(compressed, length, decompressed, capacity) <= capacity);
+        CHECK(decompressed[capacity] == GUARD_VALUE);
+    }
+
+    fillPattern(source, 5000, 2);
+    uint16_t inPlaceMargin;
+    uint16_t compressedLength = LZ4_Compress(source, 5000, compressed, USER_CONFIG_SIZE, &inPlaceMargin);
+    for (uint16_t length = 0; length < compressedLength; length += 7) {
+        CHECK(LZ4_Decompress(compressed, length, decompressed, USER_CONFIG_SIZE) < 5000);
+    }
+}
+
+static void reportConfig(const char *name, const uint8_t *config, uint16_t length)
+{
+    uint16_t compressedLength = checkRoundTrip(config, length);
+    if (compressedLength == 0) {
+        return;
+    }
+
+    clock_t start = clock();
+    for (uint16_t i = 0; i < DECODE_REPETITIONS; i++) {
+        LZ4_Decompress(compressed, compressedLength, decompressed, USER_CONFIG_SIZE);
+    }
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC / DECODE_REPETITIONS;
+
+    printf("%s: %u -> %u bytes, ratio %.2f, decoded at %.0f MB/s\n", name, length, compressedLength, (double)length / compressedLength, length / seconds / 1e6);
+}
+
+// Configs saved by Agent can be passed as arguments, built ones are checked anyway.
+static void testConfigs(int argc, char **argv)
+{
+    static const uint8_t shapes[][2] = {{1, 0}, {4, 10}, {8, 40}, {12, 100}};
+    char name[64];
+
+    for (uint8_t i = 0; i < sizeof shapes / sizeof shapes[0]; i++) {
+        uint16_t length = ConfigBuilder_Build(source, USER_CONFIG_SIZE, i, shapes[i][0], shapes[i][1]);
+        CHECK(length != 0);
+        snprintf(name, sizeof name, "%u keymaps, %u macros", shapes[i][0], shapes[i][1]);
+        reportConfig(name, source, length);
+    }
+
+    for (int i = 1; i < argc; i++) {
+        FILE *file = fopen(argv[i], "rb");
+        CHECK(file != NULL);
+        if (file) {
+            uint16_t length = fread(source, 1, USER_CONFIG_SIZE, file);
+            fclose(file);
+            reportConfig(argv[i], source, length);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    testRoundTrips();
+    testSmallDestinations();
+    testCorruptedInput();
+    testConfigs(argc, argv);
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,54 @@
+#include "test.h"
+#include "motion_burst.h"
+
+static void testNoMotion(void)
+{
+    motion_delta_t delta = {1, 1};
+
+    CHECK(!MotionBurst_Decode((uint8_t[]){0x00, 0x05, 0xfe, 0x0f}, &delta));
+    CHECK(delta.x == 0 && delta.y == 0);
+
+    // The overflow bit alone doesn't mean motion.
+    CHECK(!MotionBurst_Decode((uint8_t[]){MOTION_OVERFLOW_BIT, 0x05, 0xfe, 0x0f}, &delta));
+    CHECK(delta.x == 0 && delta.y == 0);
+}
+
+static void testDeltas(void)
+{
+    motion_delta_t delta;
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT, 0xff, 0x01, 0xf0}, &delta));
+    CHECK(delta.x == -1 && delta.y == 1);
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT, 0x34, 0xcd, 0x2a}, &delta));
+    CHECK(delta.x == 0x234 && delta.y == 0xacd - 0x1000);
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT, 0xff, 0x00, 0x78}, &delta));
+    CHECK(delta.x == MOTION_DELTA_MAX && delta.y == MOTION_DELTA_MIN);
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT, 0x00, 0xff, 0x87}, &delta));
+    CHECK(delta.x == MOTION_DELTA_MIN && delta.y == MOTION_DELTA_MAX);
+}
+
+static void testOverflow(void)
+{
+    motion_delta_t delta;
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT | MOTION_OVERFLOW_BIT, 0x05, 0xfe, 0x0f}, &delta));
+    CHECK(delta.x == MOTION_DELTA_MAX && delta.y == MOTION_DELTA_MIN);
+
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT | MOTION_OVERFLOW_BIT, 0xfb, 0x02, 0xf0}, &delta));
+    CHECK(delta.x == MOTION_DELTA_MIN && delta.y == MOTION_DELTA_MAX);
+
+    // Without a sign to go by, an axis stays still.
+    CHECK(MotionBurst_Decode((uint8_t[]){MOTION_BIT | MOTION_OVERFLOW_BIT, 0x00, 0x01, 0x00}, &delta));
+    CHECK(delta.x == 0 && delta.y == MOTION_DELTA_MAX);
+}
+
+int main(void)
+{
+    testNoMotion();
+    testDeltas();
+    testOverflow();
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,220 @@
+#include <math.h>
+#include "test.h"
+#include "pointer_filter.h"
+
+// Replays pointer delta traces through the filter and reports how much jitter it removes and how
+// much lag it adds in exchange. Further traces can be given as arguments, as text files with a
+// line of `<elapsed time in us> <x delta> <y delta>` per sample, and `#` starting comment lines.
+
+#define TRACE_CAPACITY 100000
+
+// The filter is flushed this long after a trace, which must release all lag.
+#define FLUSH_TIME_US 5000000
+#define SAMPLE_INTERVAL_US 1000
+
+typedef struct {
+    uint32_t elapsedTimeUs;
+    int16_t x;
+    int16_t y;
+} trace_sample_t;
+
+typedef struct {
+    const char *name;
+    trace_sample_t samples[TRACE_CAPACITY];
+    uint32_t sampleCount;
+} trace_t;
+
+typedef struct {
+    float minCutoff;
+    float beta;
+} filter_setting_t;
+
+typedef struct {
+    float jitter; // mean absolute change of the delta between samples, px
+    float meanLag; // mean distance behind the raw position, px
+    float maxLag;
+    bool isMovementKept;
+} replay_result_t;
+
+typedef enum {
+    DISABLED_SETTING,
+    SUGGESTED_SETTING,
+    STRONG_SETTING,
+    FILTER_SETTING_COUNT,
+} filter_setting_id_t;
+
+static const filter_setting_t filterSettings[FILTER_SETTING_COUNT] = {
+    [DISABLED_SETTING] = {0.0f, 0.0f},
+    [SUGGESTED_SETTING] = {1.0f, 5.0f},
+    [STRONG_SETTING] = {0.5f, 1.0f},
+};
+
+static trace_t trace;
+
+static int16_t noise(void)
+{
+    return rand() % 3 - 1;
+}
+
+static void addSample(trace_t *trace, int16_t x, int16_t y)
+{
+    trace->samples[trace->sampleCount++] = (trace_sample_t){SAMPLE_INTERVAL_US, x, y};
+}
+
+// A resting finger on a touchpad, or a trackball sensor picking up vibrations.
+static void buildRestTrace(trace_t *trace)
+{
+    trace->name = "rest";
+    trace->sampleCount = 0;
+    for (uint16_t i = 0; i < 2000; i++) {
+        addSample(trace, noise(), noise());
+    }
+}
+
+// Aiming slowly at a small target, at 0.2 px/ms with jitter.
+static void buildSlowTrace(trace_t *trace)
+{
+    trace->name = "slow";
+    trace->sampleCount = 0;
+    for (uint16_t i = 0; i < 2000; i++) {
+        addSample(trace, (i % 5 == 0) + noise(), noise());
+    }
+}
+
+// A quick flick across the screen followed by a stop.
+static void buildFlickTrace(trace_t *trace)
+{
+    trace->name = "flick";
+    trace->sampleCount = 0;
+    for (uint16_t i = 0; i < 100; i++) {
+        addSample(trace, 20, -8);
+    }
+    for (uint16_t i = 0; i < 400; i++) {
+        addSample(trace, 0, 0);
+    }
+}
+
+static bool readTrace(trace_t *trace, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[128];
+
+    if (!file) {
+        return false;
+    }
+    trace->name = path;
+    trace->sampleCount = 0;
+    while (fgets(line, sizeof(line), file) && trace->sampleCount < TRACE_CAPACITY) {
+        trace_sample_t *sample = &trace->samples[trace->sampleCount];
+        if (line[0] != '#' && sscanf(line, "%u %hd %hd", &sample->elapsedTimeUs, &sample->x, &sample->y) == 3) {
+            trace->sampleCount++;
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+static replay_result_t replayTrace(const trace_t *trace, const filter_setting_t *setting)
+{
+    pointer_filter_t filter = {0};
+    replay_result_t result = {0};
+    int64_t rawX = 0, rawY = 0;
+    int64_t filteredX = 0, filteredY = 0;
+    int16_t previousX = 0, previousY = 0;
+    double jitterSum = 0, lagSum = 0;
+
+    PointerFilter_Configure(&filter, setting->minCutoff, setting->beta);
+
+    for (uint32_t i = 0; i < trace->sampleCount; i++) {
+        const trace_sample_t *sample = &trace->samples[i];
+        int16_t x = sample->x;
+        int16_t y = sample->y;
+
+        PointerFilter_Apply(&filter, &x, &y, sample->elapsedTimeUs);
+        rawX += sample->x;
+        rawY += sample->y;
+        filteredX += x;
+        filteredY += y;
+
+        jitterSum += hypot(x - previousX, y - previousY);
+        previousX = x;
+        previousY = y;
+
+        float lag = hypot(rawX - filteredX, rawY - filteredY);
+        lagSum += lag;
+        if (lag > result.maxLag) {
+            result.maxLag = lag;
+        }
+    }
+
+    for (uint32_t time = 0; time < FLUSH_TIME_US; time += SAMPLE_INTERVAL_US) {
+        int16_t x = 0;
+        int16_t y = 0;
+        PointerFilter_Apply(&filter, &x, &y, SAMPLE_INTERVAL_US);
+        filteredX += x;
+        filteredY += y;
+    }
+
+    result.jitter = trace->sampleCount ? jitterSum / trace->sampleCount : 0;
+    result.meanLag = trace->sampleCount ? lagSum / trace->sampleCount : 0;
+    result.isMovementKept = filteredX == rawX && filteredY == rawY;
+    return result;
+}
+
+// Replays the trace with every setting, and checks the properties that hold for any trace.
+static void reportTrace(const trace_t *trace, replay_result_t results[])
+{
+    for (uint8_t i = 0; i < FILTER_SETTING_COUNT; i++) {
+        const filter_setting_t *setting = &filterSettings[i];
+        replay_result_t *result = &results[i];
+
+        *result = replayTrace(trace, setting);
+        CHECK(result->isMovementKept);
+        if (setting->minCutoff == 0) {
+            CHECK(result->maxLag == 0);
+        }
+        printf("%s trace, minCutoff %.1f beta %.1f: jitter %.3f px, lag %.2f px mean, %.2f px max\n", trace->name, setting->minCutoff, setting->beta, result->jitter, result->meanLag, result->maxLag);
+    }
+}
+
+static void testRestJitterIsSmoothed(void)
+{
+    replay_result_t results[FILTER_SETTING_COUNT];
+
+    buildRestTrace(&trace);
+    reportTrace(&trace, results);
+    CHECK(results[SUGGESTED_SETTING].jitter < results[DISABLED_SETTING].jitter / 4);
+}
+
+static void testSlowMovementIsSmoothed(void)
+{
+    replay_result_t results[FILTER_SETTING_COUNT];
+
+    buildSlowTrace(&trace);
+    reportTrace(&trace, results);
+    CHECK(results[SUGGESTED_SETTING].jitter < results[DISABLED_SETTING].jitter / 2);
+}
+
+// Fast movements raise the cutoff with beta, so a higher beta lags less.
+static void testFlickLagsLessWithHigherBeta(void)
+{
+    replay_result_t results[FILTER_SETTING_COUNT];
+
+    buildFlickTrace(&trace);
+    reportTrace(&trace, results);
+    CHECK(results[SUGGESTED_SETTING].maxLag < results[STRONG_SETTING].maxLag);
+}
+
+int main(int argc, char *argv[])
+{
+    testRestJitterIsSmoothed();
+    testSlowMovementIsSmoothed();
+    testFlickLagsLessWithHigherBeta();
+
+    for (int i = 1; i < argc; i++) {
+        replay_result_t results[FILTER_SETTING_COUNT];
+        CHECK(readTrace(&trace, argv[i]));
+        reportTrace(&trace, results);
+    }
+    return TEST_EXIT_STATUS;
+}
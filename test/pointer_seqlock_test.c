@@ -0,0 +1,110 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include "test.h"
+#include "pointer_seqlock.h"
+
+#define STRESS_UPDATE_COUNT 20000000
+
+static pointer_seqlock_t stressSeqlock;
+static atomic_bool isProducerDone;
+static int64_t producedX;
+static int64_t producedY;
+
+static void testTakeSplitsLargeDeltas(void)
+{
+    pointer_seqlock_t seqlock = {0};
+    pointer_delta_t delta;
+
+    for (int i = 0; i < 3; i++) {
+        PointerSeqlock_Add(&seqlock, 20000, -20000, i);
+    }
+
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == INT16_MAX && delta.y == INT16_MIN && delta.sampleTime == 2);
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == 60000 - INT16_MAX && delta.y == -60000 - INT16_MIN);
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == 0 && delta.y == 0);
+}
+
+static void testDiscardDropsPendingMovement(void)
+{
+    pointer_seqlock_t seqlock = {0};
+    pointer_delta_t delta;
+
+    PointerSeqlock_Add(&seqlock, 5, 7, 1);
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    PointerSeqlock_Add(&seqlock, 100, -100, 2);
+    PointerSeqlock_Discard(&seqlock);
+    PointerSeqlock_Add(&seqlock, 3, 4, 3);
+
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == 3 && delta.y == 4 && delta.sampleTime == 3);
+}
+
+static void testTakeFailsDuringUpdate(void)
+{
+    pointer_seqlock_t seqlock = {0};
+    pointer_delta_t delta;
+
+    PointerSeqlock_Add(&seqlock, 5, 7, 1);
+    seqlock.sequence++;
+    CHECK(!PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == 0 && delta.y == 0);
+    seqlock.sequence++;
+    CHECK(PointerSeqlock_Take(&seqlock, &delta));
+    CHECK(delta.x == 5 && delta.y == 7);
+}
+
+static void *produce(void *argument)
+{
+    for (int i = 0; i < STRESS_UPDATE_COUNT; i++) {
+        int16_t x = i % 7 - 3;
+        int16_t y = i % 5 - 1;
+        PointerSeqlock_Add(&stressSeqlock, x, y, i);
+        producedX += x;
+        producedY += y;
+    }
+    atomic_store(&isProducerDone, true);
+    return NULL;
+}
+
+// Races a producer thread against the consumer. Whatever the interleaving, the consumer must end
+// up with exactly the movement that was produced.
+static void testConcurrentUpdatesAddUp(void)
+{
+    pthread_t producer;
+    pointer_delta_t delta;
+    int64_t takenX = 0;
+    int64_t takenY = 0;
+    uint32_t failedTakeCount = 0;
+
+    CHECK(pthread_create(&producer, NULL, produce, NULL) == 0);
+    while (!atomic_load(&isProducerDone)) {
+        if (PointerSeqlock_Take(&stressSeqlock, &delta)) {
+            takenX += delta.x;
+            takenY += delta.y;
+        } else {
+            failedTakeCount++;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    do {
+        CHECK(PointerSeqlock_Take(&stressSeqlock, &delta));
+        takenX += delta.x;
+        takenY += delta.y;
+    } while (delta.x || delta.y);
+
+    CHECK(takenX == producedX && takenY == producedY);
+    printf("%d updates, %u takes caught an update in progress\n", STRESS_UPDATE_COUNT, failedTakeCount);
+}
+
+int main(void)
+{
+    testTakeSplitsLargeDeltas();
+    testDiscardDropsPendingMovement();
+    testTakeFailsDuringUpdate();
+    testConcurrentUpdatesAddUp();
+    return TEST_EXIT_STATUS;
+}
@@ -0,0 +1,230 @@
+#include "test.h"
+#include "ps2.h"
+
+// Falling clock edges as a logic analyzer would record them on the trackpoint lines.
+
+#define CLOCK_PERIOD_US 80
+#define TRACE_CAPACITY 64
+
+typedef struct {
+    bool data;
+    uint32_t elapsedUs;
+} ps2_edge_t;
+
+typedef struct {
+    ps2_edge_t edges[TRACE_CAPACITY];
+    uint8_t edgeCount;
+} ps2_trace_t;
+
+typedef struct {
+    ps2_event_t event;
+    ps2_drive_t drive;
+    uint8_t edgeId;
+} ps2_replay_t;
+
+static void addEdge(ps2_trace_t *trace, bool data, uint32_t elapsedUs)
+{
+    trace->edges[trace->edgeCount++] = (ps2_edge_t){data, elapsedUs};
+}
+
+// Adds the first bitCount bits of a device to host frame, the first of them after gapUs.
+static void addFrameBits(ps2_trace_t *trace, uint8_t byte, bool isParityValid, uint32_t gapUs, uint8_t bitCount)
+{
+    bool bits[PS2_FRAME_BIT_COUNT];
+    bool parity = true;
+
+    bits[0] = false;
+    for (uint8_t i = 0; i < 8; i++) {
+        bits[i + 1] = byte & (1 << i);
+        parity ^= bits[i + 1];
+    }
+    bits[9] = isParityValid ? parity : !parity;
+    bits[10] = true;
+
+    for (uint8_t i = 0; i < bitCount; i++) {
+        addEdge(trace, bits[i], i == 0 ? gapUs : CLOCK_PERIOD_US);
+    }
+}
+
+static void addFrame(ps2_trace_t *trace, uint8_t byte, bool isParityValid)
+{
+    addFrameBits(trace, byte, isParityValid, 1000, PS2_FRAME_BIT_COUNT);
+}
+
+// Feeds the edges from edgeId on, and stops at the first one that produces an event.
+static ps2_replay_t replay(ps2_line_t *line, const ps2_trace_t *trace, uint8_t edgeId)
+{
+    ps2_replay_t replay = {Ps2Event_None, Ps2Drive_None, edgeId};
+
+    for (; replay.edgeId < trace->edgeCount; replay.edgeId++) {
+        const ps2_edge_t *edge = &trace->edges[replay.edgeId];
+        replay.event = Ps2_HandleFallingEdge(line, edge->data, edge->elapsedUs, &replay.drive);
+        if (replay.event != Ps2Event_None) {
+            break;
+        }
+    }
+    return replay;
+}
+
+static void testBytesAreReceived(void)
+{
+    ps2_line_t line;
+    ps2_trace_t trace = {0};
+    ps2_replay_t result;
+
+    addFrame(&trace, PS2_RESPONSE_ACK, true);
+    addFrame(&trace, 0x00, true);
+    addFrame(&trace, 0xff, true);
+
+    Ps2_Init(&line);
+    result = replay(&line, &trace, 0);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 10 && line.byte == PS2_RESPONSE_ACK);
+    result = replay(&line, &trace, result.edgeId + 1);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 21 && line.byte == 0x00);
+    result = replay(&line, &trace, result.edgeId + 1);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 32 && line.byte == 0xff);
+}
+
+// The frame is only rejected once its stop bit is in, so the next frame starts in sync.
+static void testParityErrorDropsTheByte(void)
+{
+    ps2_line_t line;
+    ps2_trace_t trace = {0};
+    ps2_replay_t result;
+
+    addFrame(&trace, 0x42, false);
+    addFrame(&trace, 0x43, true);
+
+    Ps2_Init(&line);
+    result = replay(&line, &trace, 0);
+    CHECK(result.event == Ps2Event_Error && result.edgeId == 10 && line.lastError == Ps2Error_Parity);
+    result = replay(&line, &trace, result.edgeId + 1);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 21 && line.byte == 0x43);
+}
+
+static void testMissingStopBitIsAnError(void)
+{
+    ps2_line_t line;
+    ps2_trace_t trace = {0};
+    ps2_replay_t result;
+
+    addFrameBits(&trace, 0x42, true, 1000, 10);
+    addEdge(&trace, false, CLOCK_PERIOD_US);
+
+    Ps2_Init(&line);
+    result = replay(&line, &trace, 0);
+    CHECK(result.event == Ps2Event_Error && result.edgeId == 10 && line.lastError == Ps2Error_StopBit);
+}
+
+// A frame that stops midway, e.g. because the host inhibited the device, is dropped by the
+// next edge that comes too late, which then starts a new frame.
+static void testTimeoutResynchronizes(void)
+{
+    ps2_line_t line;
+    ps2_trace_t trace = {0};
+    ps2_replay_t result;
+
+    addFrameBits(&trace, 0x42, true, 1000, 5);
+    addFrameBits(&trace, 0x43, true, PS2_MAX_CLOCK_PERIOD_US + 1, PS2_FRAME_BIT_COUNT);
+
+    Ps2_Init(&line);
+    result = replay(&line, &trace, 0);
+    CHECK(result.event == Ps2Event_Error && result.edgeId == 5 && line.lastError == Ps2Error_Timing);
+    result = replay(&line, &trace, result.edgeId + 1);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 15 && line.byte == 0x43);
+}
+
+// An edge that comes too early is a glitch that has shifted the bits of the frame. The parity bit
+// of 0x42 is one, so the shifted frame still ends with what looks like a stop bit.
+static void testGlitchCorruptsTheFrame(void)
+{
+    ps2_line_t line;
+    ps2_trace_t trace = {0};
+    ps2_replay_t result;
+
+    addFrameBits(&trace, 0x42, true, 1000, 10);
+    for (uint8_t i = 10; i > 4; i--) {
+        trace.edges[i] = trace.edges[i - 1];
+    }
+    trace.edges[4] = (ps2_edge_t){true, PS2_MIN_CLOCK_PERIOD_US - 1};
+    trace.edgeCount++;
+    addFrame(&trace, 0x43, true);
+
+    Ps2_Init(&line);
+    result = replay(&line, &trace, 0);
+    CHECK(result.event == Ps2Event_Error && result.edgeId == 10 && line.lastError == Ps2Error_Timing);
+    result = replay(&line, &trace, result.edgeId + 1);
+    CHECK(result.event == Ps2Event_ByteReceived && result.edgeId == 21 && line.byte == 0x43);
+}
+
+// The device clocks host to device frames too, the data line is driven on each falling edge.
+static void testBytesAreTransmitted(void)
+{
+    ps2_line_t line;
+    ps2_drive_t drives[PS2_FRAME_BIT_COUNT];
+    ps2_event_t event = Ps2Event_None;
+    uint8_t byte = PS2_COMMAND_ENABLE_REPORTING;
+    bool parity = true;
+
+    Ps2_Init(&line);
+    Ps2_StartTransmit(&line, byte);
+    for (uint8_t i = 0; i < PS2_FRAME_BIT_COUNT; i++) {
+        event = Ps2_HandleFallingEdge(&line, i < 10, i == 0 ? 1000 : CLOCK_PERIOD_US, &drives[i]);
+        CHECK(event == (i < 10 ? Ps2Event_None : Ps2Event_ByteSent));
+    }
+
+    for (uint8_t i = 0; i < 8; i++) {
+        bool bit = byte & (1 << i);
+        parity ^= bit;
+        CHECK(drives[i] == (bit ? Ps2Drive_High : Ps2Drive_Low));
+    }
+    CHECK(drives[8] == (parity ? Ps2Drive_High : Ps2Drive_Low));
+    CHECK(drives[9] == Ps2Drive_High);
+    CHECK(drives[10] == Ps2Drive_Release);
+    CHECK(!line.isTransmitting);
+}
+
+// A device that stops clocking midway through a transmission gets the data line released.
+static void testTransmitTimeoutReleasesTheLine(void)
+{
+    ps2_line_t line;
+    ps2_drive_t drive;
+
+    Ps2_Init(&line);
+    Ps2_StartTransmit(&line, PS2_COMMAND_RESET);
+    for (uint8_t i = 0; i < 4; i++) {
+        CHECK(Ps2_HandleFallingEdge(&line, true, CLOCK_PERIOD_US, &drive) == Ps2Event_None);
+    }
+    CHECK(Ps2_HandleFallingEdge(&line, false, PS2_MAX_CLOCK_PERIOD_US + 1, &drive) == Ps2Event_Error);
+    CHECK(drive == Ps2Drive_Release && line.lastError == Ps2Error_Timing && !line.isTransmitting);
+}
+
+static void testMovementPackets(void)
+{
+    int16_t x, y;
+
+    CHECK(Ps2_IsPacketStart(0x08));
+    CHECK(Ps2_IsPacketStart(0x08 | PS2_PACKET_X_SIGN | PS2_PACKET_Y_SIGN | 0x07));
+    CHECK(!Ps2_IsPacketStart(0x00));
+    CHECK(!Ps2_IsPacketStart(0x48));
+    CHECK(!Ps2_IsPacketStart(0x88));
+
+    Ps2_DecodeMovementPacket((uint8_t[]){0x08, 0x05, 0x7f}, &x, &y);
+    CHECK(x == 5 && y == 127);
+
+    Ps2_DecodeMovementPacket((uint8_t[]){0x08 | PS2_PACKET_X_SIGN | PS2_PACKET_Y_SIGN, 0xff, 0x00}, &x, &y);
+    CHECK(x == -1 && y == -256);
+}
+
+int main(void)
+{
+    testBytesAreReceived();
+    testParityErrorDropsTheByte();
+    testMissingStopBitIsAnError();
+    testTimeoutResynchronizes();
+    testGlitchCorruptsTheFrame();
+    testBytesAreTransmitted();
+    testTransmitTimeoutReleasesTheLine();
+    testMovementPackets();
+    return TEST_EXIT_STATUS;
+}
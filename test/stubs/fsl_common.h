@@ -0,0 +1,52 @@
+#ifndef __FSL_COMMON_H__
+#define __FSL_COMMON_H__
+
+// Stands in for the KSDK header when building on the host, with just enough for the tested modules.
+
+// Includes:
+
+    #include <stdbool.h>
+    #include <stddef.h>
+    #include <stdint.h>
+    #include <string.h>
+
+// Macros:
+
+    #define MIN(a, b) ((a) < (b) ? (a) : (b))
+    #define MAX(a, b) ((a) > (b) ? (a) : (b))
+
+    #define MAKE_STATUS(group, code) ((((group) * 100) + (code)))
+    #define USEC_TO_COUNT(us, clockFreqInHz) ((uint64_t)(us) * (clockFreqInHz) / 1000000U)
+
+    #define EnableIRQ(irq)
+    #define DisableIRQ(irq)
+
+    #define __packed __attribute__((packed))
+
+// Typedefs:
+
+    typedef int32_t status_t;
+
+    enum {
+        kStatusGroup_Generic = 0,
+        kStatusGroup_I2C = 13,
+    };
+
+    enum {
+        kStatus_Success = MAKE_STATUS(kStatusGroup_Generic, 0),
+        kStatus_Fail = MAKE_STATUS(kStatusGroup_Generic, 1),
+    };
+
+    typedef enum {
+        kCLOCK_BusClk,
+    } clock_name_t;
+
+    typedef enum {
+        PIT2_IRQn = 50,
+    } IRQn_Type;
+
+// Functions:
+
+    uint32_t CLOCK_GetFreq(clock_name_t clockName);
+
+#endif
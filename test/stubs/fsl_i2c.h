@@ -0,0 +1,57 @@
+#ifndef __FSL_I2C_H__
+#define __FSL_I2C_H__
+
+// Includes:
+
+    #include "fsl_common.h"
+
+// Macros:
+
+    #define I2C0 ((I2C_Type *)0)
+    #define I2C1 ((I2C_Type *)1)
+
+// Typedefs:
+
+    typedef struct {
+        int unused;
+    } I2C_Type;
+
+    enum {
+        kStatus_I2C_Busy = MAKE_STATUS(kStatusGroup_I2C, 0),
+        kStatus_I2C_Idle = MAKE_STATUS(kStatusGroup_I2C, 1),
+        kStatus_I2C_Nak = MAKE_STATUS(kStatusGroup_I2C, 2),
+        kStatus_I2C_ArbitrationLost = MAKE_STATUS(kStatusGroup_I2C, 3),
+        kStatus_I2C_Timeout = MAKE_STATUS(kStatusGroup_I2C, 4),
+        kStatus_I2C_Addr_Nak = MAKE_STATUS(kStatusGroup_I2C, 5),
+    };
+
+    typedef enum {
+        kI2C_Write = 0,
+        kI2C_Read = 1,
+    } i2c_direction_t;
+
+    typedef struct {
+        uint32_t flags;
+        uint8_t slaveAddress;
+        i2c_direction_t direction;
+        uint32_t subaddress;
+        uint8_t subaddressSize;
+        uint8_t *volatile data;
+        volatile size_t dataSize;
+    } i2c_master_transfer_t;
+
+    typedef struct _i2c_master_handle i2c_master_handle_t;
+
+    typedef void (*i2c_master_transfer_callback_t)(I2C_Type *base, i2c_master_handle_t *handle, status_t status, void *userData);
+
+    struct _i2c_master_handle {
+        i2c_master_transfer_t transfer;
+        i2c_master_transfer_callback_t completionCallback;
+        void *userData;
+    };
+
+// Functions:
+
+    void I2C_MasterTransferCreateHandle(I2C_Type *base, i2c_master_handle_t *handle, i2c_master_transfer_callback_t callback, void *userData);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef __FSL_I2C_EDMA_H__
+#define __FSL_I2C_EDMA_H__
+
+// Includes:
+
+    #include "fsl_i2c.h"
+
+// Macros:
+
+    #define DMA_CITER_ELINKNO_CITER_MASK 0x7FFFU
+
+// Typedefs:
+
+    typedef enum {
+        kDmaRequestMux0I2C0 = 22,
+        kDmaRequestMux0I2C1 = 23,
+    } dma_request_source_t;
+
+    typedef struct {
+        uint8_t channel;
+    } edma_handle_t;
+
+    typedef struct _i2c_master_edma_handle i2c_master_edma_handle_t;
+
+    typedef void (*i2c_master_edma_transfer_callback_t)(I2C_Type *base, i2c_master_edma_handle_t *handle, status_t status, void *userData);
+
+    struct _i2c_master_edma_handle {
+        i2c_master_transfer_t transfer;
+        edma_handle_t *dmaHandle;
+        i2c_master_edma_transfer_callback_t completionCallback;
+        void *userData;
+    };
+
+#endif
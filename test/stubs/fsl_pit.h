@@ -0,0 +1,47 @@
+#ifndef __FSL_PIT_H__
+#define __FSL_PIT_H__
+
+// Includes:
+
+    #include "fsl_common.h"
+
+// Macros:
+
+    #define PIT ((PIT_Type *)0)
+
+// Typedefs:
+
+    typedef struct {
+        int unused;
+    } PIT_Type;
+
+    typedef struct {
+        bool enableRunInDebug;
+    } pit_config_t;
+
+    typedef enum {
+        kPIT_Chnl_0,
+        kPIT_Chnl_1,
+        kPIT_Chnl_2,
+        kPIT_Chnl_3,
+    } pit_chnl_t;
+
+    typedef enum {
+        kPIT_TimerInterruptEnable = 1,
+    } pit_interrupt_enable_t;
+
+    typedef enum {
+        kPIT_TimerFlag = 1,
+    } pit_status_flags_t;
+
+// Functions:
+
+    void PIT_GetDefaultConfig(pit_config_t *config);
+    void PIT_Init(PIT_Type *base, const pit_config_t *config);
+    void PIT_EnableInterrupts(PIT_Type *base, pit_chnl_t channel, uint32_t mask);
+    void PIT_SetTimerPeriod(PIT_Type *base, pit_chnl_t channel, uint32_t count);
+    void PIT_StartTimer(PIT_Type *base, pit_chnl_t channel);
+    void PIT_StopTimer(PIT_Type *base, pit_chnl_t channel);
+    void PIT_ClearStatusFlags(PIT_Type *base, pit_chnl_t channel, uint32_t mask);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef __USB_H__
+#define __USB_H__
+
+// Includes:
+
+    #include "fsl_common.h"
+
+// Macros:
+
+    #define USB_SETUP_PACKET_SIZE 8
+
+// Typedefs:
+
+    typedef enum {
+        kStatus_USB_Success,
+        kStatus_USB_Error,
+    } usb_status_t;
+
+    typedef void *usb_device_handle;
+
+    typedef struct {
+        uint8_t bmRequestType;
+        uint8_t bRequest;
+        uint16_t wValue;
+        uint16_t wIndex;
+        uint16_t wLength;
+    } usb_setup_struct_t;
+
+    typedef usb_status_t (*usb_device_callback_t)(usb_device_handle handle, uint32_t callbackEvent, void *eventParam);
+
+#endif
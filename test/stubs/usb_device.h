@@ -0,0 +1,8 @@
+#ifndef __USB_DEVICE_H__
+#define __USB_DEVICE_H__
+
+// Includes:
+
+    #include "usb.h"
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __TEST_H__
+#define __TEST_H__
+
+// Includes:
+
+    #include <stdio.h>
+    #include <stdlib.h>
+
+// Macros:
+
+    #define CHECK(condition) do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            testFailureCount++; \
+        } \
+    } while (0)
+
+    #define TEST_EXIT_STATUS (testFailureCount ? EXIT_FAILURE : EXIT_SUCCESS)
+
+// Variables:
+
+    static int testFailureCount;
+
+#endif
@@ -2,6 +2,8 @@
 #include "fsl_port.h"
 #include "fsl_spi.h"
 #include "module.h"
+#include "module/key_scanner.h"
+#include "motion_burst.h"
 
 #define TRACKBALL_SHTDWN_PORT PORTA
 #define TRACKBALL_SHTDWN_GPIO GPIOA
@@ -35,8 +37,9 @@
 
 #define TRACKBALL_SPI_MASTER SPI0
 #define TRACKBALL_SPI_MASTER_SOURCE_CLOCK kCLOCK_BusClk
+#define TRACKBALL_SPI_BAUD_RATE 1000000U // The maximum serial port clock of the sensor.
 
-pointer_delta_t PointerDelta;
+pointer_seqlock_t PointerDelta;
 
 key_vector_t KeyVector = {
     .itemNum = KEYBOARD_VECTOR_ITEMS_NUM,
@@ -47,16 +50,15 @@ key_vector_t KeyVector = {
     .keyStates = {0}
 };
 
-#define BUFFER_SIZE 2
-#define MOTION_BIT (1<<7)
+#define COMMAND_SIZE 2
+#define MOTION_BURST_SIZE (1 + MOTION_BURST_LENGTH)
+#define BUFFER_SIZE MOTION_BURST_SIZE
 
 typedef enum {
     ModulePhase_SetResolution,
     ModulePhase_SetRestRate3,
     ModulePhase_Initialized,
-    ModulePhase_ProcessMotion,
-    ModulePhase_ProcessDeltaY,
-    ModulePhase_ProcessDeltaX,
+    ModulePhase_ProcessMotionBurst,
 } module_phase_t;
 
 module_phase_t modulePhase = ModulePhase_SetResolution;
@@ -64,58 +66,45 @@ module_phase_t modulePhase = ModulePhase_SetResolution;
 uint8_t txBufferPowerUpReset[] = {0xba, 0x5a};
 uint8_t txSetResolution[] = {0x91, 0b10000000};
 uint8_t txSetRestRate3[] = {0x18, 0x09};
-uint8_t txBufferGetMotion[] = {0x02, 0x00};
-uint8_t txBufferGetDeltaY[] = {0x03, 0x00};
-uint8_t txBufferGetDeltaX[] = {0x04, 0x00};
+uint8_t txBufferGetMotionBurst[MOTION_BURST_SIZE] = {MOTION_BURST_REGISTER};
 
 uint8_t rxBuffer[BUFFER_SIZE];
 spi_master_handle_t handle;
 spi_transfer_t xfer = {0};
 
-void tx(uint8_t *txBuff)
+void tx(uint8_t *txBuff, size_t size)
 {
     GPIO_WritePinOutput(TRACKBALL_NCS_GPIO, TRACKBALL_NCS_PIN, 1);
     GPIO_WritePinOutput(TRACKBALL_NCS_GPIO, TRACKBALL_NCS_PIN, 0);
     xfer.txData = txBuff;
+    xfer.dataSize = size;
     SPI_MasterTransferNonBlocking(TRACKBALL_SPI_MASTER, &handle, &xfer);
 }
 
+// Motion is polled by chaining SPI transfers from their completion callback, independently of
+// the key scanner. Every sample is a single motion burst read of motion, delta X and delta Y.
 void trackballUpdate(SPI_Type *base, spi_master_handle_t *masterHandle, status_t status, void *userData)
 {
     switch (modulePhase) {
         case ModulePhase_SetResolution:
-            tx(txSetResolution);
+            tx(txSetResolution, COMMAND_SIZE);
             modulePhase = ModulePhase_SetRestRate3;
             break;
         case ModulePhase_SetRestRate3:
-            tx(txSetRestRate3);
+            tx(txSetRestRate3, COMMAND_SIZE);
             modulePhase = ModulePhase_Initialized;
             break;
         case ModulePhase_Initialized:
-            tx(txBufferGetMotion);
-            modulePhase = ModulePhase_ProcessMotion;
+            tx(txBufferGetMotionBurst, MOTION_BURST_SIZE);
+            modulePhase = ModulePhase_ProcessMotionBurst;
             break;
-        case ModulePhase_ProcessMotion: ;
-            uint8_t motion = rxBuffer[1];
-            bool isMoved = motion & MOTION_BIT;
-            if (isMoved) {
-                tx(txBufferGetDeltaY);
-                modulePhase = ModulePhase_ProcessDeltaY;
-            } else {
-                tx(txBufferGetMotion);
+        case ModulePhase_ProcessMotionBurst: ;
+            motion_delta_t delta;
+            if (MotionBurst_Decode(rxBuffer + 1, &delta)) {
+                // This is correct given the sensor orientation.
+                PointerSeqlock_Add(&PointerDelta, delta.x, delta.y, CurrentTime);
             }
-            break;
-        case ModulePhase_ProcessDeltaY: ;
-            int8_t deltaY = (int8_t)rxBuffer[1];
-            PointerDelta.x += deltaY; // This is correct given the sensor orientation.
-            tx(txBufferGetDeltaX);
-            modulePhase = ModulePhase_ProcessDeltaX;
-            break;
-        case ModulePhase_ProcessDeltaX: ;
-            int8_t deltaX = (int8_t)rxBuffer[1];
-            PointerDelta.y += deltaX; // This is correct given the sensor orientation.
-            tx(txBufferGetMotion);
-            modulePhase = ModulePhase_ProcessMotion;
+            tx(txBufferGetMotionBurst, MOTION_BURST_SIZE);
             break;
     }
 }
@@ -143,13 +132,12 @@ void Trackball_Init(void)
     SPI_MasterGetDefaultConfig(&userConfig);
     userConfig.polarity = kSPI_ClockPolarityActiveLow;
     userConfig.phase = kSPI_ClockPhaseSecondEdge;
-    userConfig.baudRate_Bps = 100000U;
+    userConfig.baudRate_Bps = TRACKBALL_SPI_BAUD_RATE;
     srcFreq = CLOCK_GetFreq(TRACKBALL_SPI_MASTER_SOURCE_CLOCK);
     SPI_MasterInit(TRACKBALL_SPI_MASTER, &userConfig, srcFreq);
     SPI_MasterTransferCreateHandle(TRACKBALL_SPI_MASTER, &handle, trackballUpdate, NULL);
     xfer.rxData = rxBuffer;
-    xfer.dataSize = BUFFER_SIZE;
-    tx(txBufferPowerUpReset);
+    tx(txBufferPowerUpReset, COMMAND_SIZE);
 }
 
 void Module_Init(void)
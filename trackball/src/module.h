@@ -6,6 +6,7 @@
     #include "module/module_api.h"
     #include "key_vector.h"
     #include "module/slave_protocol_handler.h"
+    #include "pointer_seqlock.h"
 
 // Macros:
 
@@ -28,7 +29,7 @@
 // Variables:
 
     extern key_vector_t KeyVector;
-    extern pointer_delta_t PointerDelta;
+    extern pointer_seqlock_t PointerDelta;
 
 // Functions:
 
@@ -0,0 +1,42 @@
+#include "motion_burst.h"
+
+static int16_t signExtend12(uint16_t value)
+{
+    return (int16_t)(value << 4) >> 4;
+}
+
+// If the sensor accumulated more motion than fits into its delta registers, the deltas are
+// no longer reliable, so report the maximum delta in the direction of the last known sign.
+static int16_t saturate(int16_t delta)
+{
+    if (delta < 0) {
+        return MOTION_DELTA_MIN;
+    } else if (delta > 0) {
+        return MOTION_DELTA_MAX;
+    }
+    return 0;
+}
+
+// Decodes the motion burst (Motion, Delta_X_L, Delta_Y_L, Delta_XY_H) into 12-bit deltas.
+// Returns false if the sensor doesn't report any motion.
+bool MotionBurst_Decode(const uint8_t *burst, motion_delta_t *delta)
+{
+    uint8_t motion = burst[0];
+
+    if (!(motion & MOTION_BIT)) {
+        delta->x = 0;
+        delta->y = 0;
+        return false;
+    }
+
+    uint8_t deltaXYHigh = burst[3];
+    delta->x = signExtend12(burst[1] | (deltaXYHigh & 0xf0) << 4);
+    delta->y = signExtend12(burst[2] | (deltaXYHigh & 0x0f) << 8);
+
+    if (motion & MOTION_OVERFLOW_BIT) {
+        delta->x = saturate(delta->x);
+        delta->y = saturate(delta->y);
+    }
+
+    return true;
+}
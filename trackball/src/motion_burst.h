@@ -0,0 +1,31 @@
+#ifndef __MOTION_BURST_H__
+#define __MOTION_BURST_H__
+
+// Includes:
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+// Macros:
+
+    #define MOTION_BURST_REGISTER 0x12
+    #define MOTION_BURST_LENGTH 4 // Motion, Delta_X_L, Delta_Y_L, Delta_XY_H
+
+    #define MOTION_BIT (1<<7)
+    #define MOTION_OVERFLOW_BIT (1<<4)
+
+    #define MOTION_DELTA_MAX 2047
+    #define MOTION_DELTA_MIN -2048
+
+// Typedefs:
+
+    typedef struct {
+        int16_t x;
+        int16_t y;
+    } motion_delta_t;
+
+// Functions:
+
+    bool MotionBurst_Decode(const uint8_t *burst, motion_delta_t *delta);
+
+#endif
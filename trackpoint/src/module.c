@@ -1,10 +1,22 @@
 #include "fsl_gpio.h"
+#include "fsl_port.h"
 #include "module.h"
+#include "module/key_scanner.h"
+#include "ps2.h"
 
-pointer_delta_t PointerDelta;
+#define SYSTICK_MAX_VALUE 0x00ffffff
 
-bool shouldReset = false;
-uint8_t resetTimer = 0;
+#define TP_RESET_TIME 50 // ms
+#define SELF_TEST_TIMEOUT 1000 // ms
+#define ACK_TIMEOUT 25 // ms
+#define FRAME_TIMEOUT 2 // ms
+#define PACKET_TIMEOUT 3 // ms
+#define COMMAND_RETRY_COUNT 3
+#define REQUEST_TO_SEND_TICKS 2 // Clock has to be inhibited for at least 100 us.
+
+#define PACKET_FIFO_SIZE 8
+
+pointer_seqlock_t PointerDelta;
 
 key_vector_t KeyVector = {
     .itemNum = KEYBOARD_VECTOR_ITEMS_NUM,
@@ -15,279 +27,326 @@ key_vector_t KeyVector = {
     .keyStates = {0}
 };
 
-void Module_Init(void)
-{
-    KeyVector_Init(&KeyVector);
+typedef enum {
+    TrackpointPhase_Reset,
+    TrackpointPhase_WaitForSelfTest,
+    TrackpointPhase_WaitForDeviceId,
+    TrackpointPhase_RequestToSend,
+    TrackpointPhase_Transmitting,
+    TrackpointPhase_WaitForAck,
+    TrackpointPhase_Streaming,
+} trackpoint_phase_t;
 
-    CLOCK_EnableClock(PS2_CLOCK_CLOCK);
-    PORT_SetPinConfig(PS2_CLOCK_PORT, PS2_CLOCK_PIN,
-                      &(port_pin_config_t){/*.pullSelect=kPORT_PullDown,*/ .mux=kPORT_MuxAsGpio});
-    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+typedef struct {
+    uint8_t data[PS2_PACKET_SIZE];
+    uint16_t sampleTime;
+} ps2_packet_t;
 
-    PORT_SetPinInterruptConfig(PS2_CLOCK_PORT, PS2_CLOCK_PIN, kPORT_InterruptFallingEdge);
-    EnableIRQ(PS2_CLOCK_IRQ);
-    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+// Commands sent after every successful self test. Sample rate is raised to the maximum.
+static const uint8_t initCommands[] = {
+    PS2_COMMAND_SET_SAMPLE_RATE, PS2_MAX_SAMPLE_RATE,
+    PS2_COMMAND_ENABLE_REPORTING,
+};
 
-    CLOCK_EnableClock(PS2_DATA_CLOCK);
-    PORT_SetPinConfig(PS2_DATA_PORT, PS2_DATA_PIN,
-                      &(port_pin_config_t){/*.pullSelect=kPORT_PullDown,*/ .mux=kPORT_MuxAsGpio});
-    GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+static ps2_line_t ps2Line;
+static trackpoint_phase_t phase = TrackpointPhase_Reset;
+static uint16_t phaseTime;
+static uint8_t phaseTicks;
+static uint8_t commandIdx;
+static uint8_t currentCommand;
+static uint8_t retryCount;
+static uint32_t lastEdgeTicks;
+static uint8_t edgeAge;
+static uint8_t byteAge;
 
-    CLOCK_EnableClock(TP_RST_CLOCK);
-    PORT_SetPinConfig(TP_RST_PORT, TP_RST_PIN, &(port_pin_config_t){.pullSelect=kPORT_PullDown, .mux=kPORT_MuxAsGpio});
-    GPIO_PinInit(TP_RST_GPIO, TP_RST_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=1});
+static bool shouldReset = false;
+
+static uint8_t packet[PS2_PACKET_SIZE];
+static uint8_t packetIdx;
+
+// Single producer (PS/2 clock interrupt), single consumer (Module_Loop).
+static ps2_packet_t packetFifo[PACKET_FIFO_SIZE];
+static volatile uint8_t packetFifoHead;
+static volatile uint8_t packetFifoTail;
+
+static void setPhase(trackpoint_phase_t newPhase)
+{
+    phase = newPhase;
+    phaseTime = 0;
 }
 
-static void resetBoard()
+static void setClockInterrupt(bool enabled)
 {
-    resetTimer = 50;
-    GPIO_WritePinOutput(TP_RST_GPIO, TP_RST_PIN, 0);
+    PORT_SetPinInterruptConfig(PS2_CLOCK_PORT, PS2_CLOCK_PIN, enabled ? kPORT_InterruptFallingEdge : kPORT_InterruptOrDMADisabled);
 }
 
-uint8_t phase = 0;
-uint32_t transitionCount = 1;
-uint8_t errno = 0;
+static void driveData(ps2_drive_t drive)
+{
+    switch (drive) {
+        case Ps2Drive_None:
+            break;
+        case Ps2Drive_Low:
+        case Ps2Drive_High:
+            GPIO_WritePinOutput(PS2_DATA_GPIO, PS2_DATA_PIN, drive == Ps2Drive_High);
+            GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=drive == Ps2Drive_High});
+            break;
+        case Ps2Drive_Release:
+            GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+            break;
+    }
+}
 
-void requestToSend()
+static void resetBoard()
 {
-    for (volatile uint32_t i=0; i<150; i++);
-    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=0});
-    GPIO_WritePinOutput(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, 0);
-    for (volatile uint32_t i=0; i<150; i++);
-    GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=0});
-    GPIO_WritePinOutput(PS2_DATA_GPIO, PS2_DATA_PIN, 0);
-    for (volatile uint32_t i=0; i<150; i++);
-    GPIO_WritePinOutput(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, 1);
+    setClockInterrupt(false);
+    driveData(Ps2Drive_Release);
     GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+    GPIO_WritePinOutput(TP_RST_GPIO, TP_RST_PIN, 0);
+    retryCount = 0;
+    setPhase(TrackpointPhase_Reset);
 }
 
+// Host to device transmission starts by inhibiting the clock. The rest of the request-to-send
+// sequence is finished from the scan timer, so that nothing busy-waits.
+static void sendByte(uint8_t byte)
+{
+    currentCommand = byte;
+    setClockInterrupt(false);
+    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=0});
+    phaseTicks = REQUEST_TO_SEND_TICKS;
+    setPhase(TrackpointPhase_RequestToSend);
+}
 
-bool clockValue = 0;
-bool bitValue = 0;
-uint8_t bitId = 0;
-uint8_t buffer;
+static void finishRequestToSend()
+{
+    Ps2_StartTransmit(&ps2Line, currentCommand);
+    driveData(Ps2Drive_Low); // start bit
+    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+    setClockInterrupt(true);
+    setPhase(TrackpointPhase_Transmitting);
+}
 
-static void reportError(uint8_t err) {
-    errno |= err;
+static void sendNextCommand()
+{
+    if (commandIdx < sizeof(initCommands)) {
+        sendByte(initCommands[commandIdx]);
+    } else {
+        packetIdx = 0;
+        setPhase(TrackpointPhase_Streaming);
+    }
 }
 
-// Write a PS/2 byte to buffer bit by bit, and return true when finished.
-static bool writeByte()
+// Retry the current command a few times, then fall back to resetting the device.
+static void recover()
 {
-    static bool parityBit;
+    if (retryCount++ < COMMAND_RETRY_COUNT) {
+        sendByte(currentCommand);
+    } else {
+        resetBoard();
+    }
+}
 
-    if (clockValue) {
-        // Even though we are hooked on InteruptFallingEdge, we are receiving
-        // one spurious wakeup during the initiation sequence
-        return false;
+static void pushPacket()
+{
+    uint8_t nextHead = (packetFifoHead + 1) % PACKET_FIFO_SIZE;
+    if (nextHead == packetFifoTail) {
+        // Consumer is behind, drop the packet.
+        return;
     }
+    for (uint8_t i = 0; i < PS2_PACKET_SIZE; i++) {
+        packetFifo[packetFifoHead].data[i] = packet[i];
+    }
+    packetFifo[packetFifoHead].sampleTime = CurrentTime;
+    packetFifoHead = nextHead;
+}
 
-    switch (bitId) {
-        case 0 ... 7: {
-            if (bitId == 0) {
-                parityBit = 1;
-                GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=0});
+static void processByte(uint8_t byte)
+{
+    switch (phase) {
+        case TrackpointPhase_WaitForSelfTest:
+            if (byte == PS2_RESPONSE_SELF_TEST_PASSED) {
+                setPhase(TrackpointPhase_WaitForDeviceId);
             }
-            bool dataBit = buffer & (1 << bitId);
-            if (dataBit) {
-                parityBit = !parityBit;
+            break;
+        case TrackpointPhase_WaitForDeviceId:
+            commandIdx = 0;
+            retryCount = 0;
+            sendNextCommand();
+            break;
+        case TrackpointPhase_WaitForAck:
+            if (byte == PS2_RESPONSE_ACK) {
+                if (currentCommand == PS2_COMMAND_RESET) {
+                    setPhase(TrackpointPhase_WaitForSelfTest);
+                } else {
+                    retryCount = 0;
+                    commandIdx++;
+                    sendNextCommand();
+                }
+            } else if (byte == PS2_RESPONSE_RESEND) {
+                recover();
+            } else {
+                resetBoard();
             }
-            GPIO_WritePinOutput(PS2_DATA_GPIO, PS2_DATA_PIN, dataBit);
             break;
-        }
-        case 8: {
-            GPIO_WritePinOutput(PS2_DATA_GPIO, PS2_DATA_PIN, parityBit);
+        case TrackpointPhase_Streaming:
+            if (packetIdx == 0 && !Ps2_IsPacketStart(byte)) {
+                // Out of sync, skip bytes until a plausible packet start.
+                break;
+            }
+            packet[packetIdx++] = byte;
+            if (packetIdx == PS2_PACKET_SIZE) {
+                packetIdx = 0;
+                pushPacket();
+            }
             break;
-        }
-        case 9: {
-            uint8_t stopBit = 1;
-            GPIO_WritePinOutput(PS2_DATA_GPIO, PS2_DATA_PIN, stopBit);
+        default:
             break;
-        }
-        case 10: {
-            GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
-            bitId = 0;
-            return true;
-        }
     }
-
-    bitId++;
-    return false;
 }
 
-// Read a PS/2 byte from buffer bit by bit, and return true when finished.
-static bool readByte()
+void Module_Init(void)
 {
-    static bool parityBit = 1;
+    KeyVector_Init(&KeyVector);
 
-    switch (bitId) {
-        case 0: {
-            buffer = 0;
-            parityBit = 1;
-            break;
-        }
-        case 1 ... 8: {
-            parityBit ^= bitValue;
-            buffer = buffer | (bitValue << (bitId-1));
-            break;
-        }
-        case 9: {
-            if (parityBit != bitValue) {
-                reportError(4);
-            }
-            break;
-        }
-        case 10: {
-             bitId = 0;
-             return true;
-         }
-    }
+    // SysTick is used as a free running timestamp of clock edges, without its interrupt.
+    SysTick->LOAD = SYSTICK_MAX_VALUE;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    Ps2_Init(&ps2Line);
 
-    bitId++;
-    return false;
+    CLOCK_EnableClock(PS2_CLOCK_CLOCK);
+    PORT_SetPinConfig(PS2_CLOCK_PORT, PS2_CLOCK_PIN,
+                      &(port_pin_config_t){/*.pullSelect=kPORT_PullDown,*/ .mux=kPORT_MuxAsGpio});
+    GPIO_PinInit(PS2_CLOCK_GPIO, PS2_CLOCK_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+    EnableIRQ(PS2_CLOCK_IRQ);
+
+    CLOCK_EnableClock(PS2_DATA_CLOCK);
+    PORT_SetPinConfig(PS2_DATA_PORT, PS2_DATA_PIN,
+                      &(port_pin_config_t){/*.pullSelect=kPORT_PullDown,*/ .mux=kPORT_MuxAsGpio});
+    GPIO_PinInit(PS2_DATA_GPIO, PS2_DATA_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalInput, .outputLogic=0});
+
+    CLOCK_EnableClock(TP_RST_CLOCK);
+    PORT_SetPinConfig(TP_RST_PORT, TP_RST_PIN, &(port_pin_config_t){.pullSelect=kPORT_PullDown, .mux=kPORT_MuxAsGpio});
+    GPIO_PinInit(TP_RST_GPIO, TP_RST_PIN, &(gpio_pin_config_t){.pinDirection=kGPIO_DigitalOutput, .outputLogic=0});
+
+    // Hold the trackpoint in reset, it will perform its self test once released.
+    resetBoard();
 }
 
 void PS2_CLOCK_IRQ_HANDLER(void) {
-    static uint8_t byte1 = 0;
-    static uint16_t deltaX = 0;
-    static uint16_t deltaY = 0;
-    static uint16_t lastX = 0;
-    static uint16_t lastY = 0;
-    static uint16_t lastClock;
-
     GPIO_ClearPinsInterruptFlags(PS2_CLOCK_GPIO, 1U << PS2_CLOCK_PIN);
 
-    bitValue = GPIO_ReadPinInput(PS2_CLOCK_GPIO, PS2_DATA_PIN);
-    clockValue = GPIO_ReadPinInput(PS2_CLOCK_GPIO, PS2_CLOCK_PIN);
-
-    uint16_t currentClock = SysTick->VAL;
-    uint16_t diff = lastClock - currentClock;
-    lastClock = currentClock;
-
-    if ((diff < 200 || diff > 240 ) && currentClock < lastClock && bitId > 0 && phase >= 7) {
-        // In current configuration, SysTick value is internal clock divided by
-        // 16, and *de*creasing by one by one. CPU clock frequency is 48Mhz.
-        // Observed PS2 period is 220 SysTick ticks. This means one tick every
-        // 73 us. This gives 13.6 kHz on PS2 clock.
-        //
-        // If timing is bad, perform rest of the handler as normally, but mark
-        // it as corrupted.
-        reportError(16);
+    bool dataIn = GPIO_ReadPinInput(PS2_DATA_GPIO, PS2_DATA_PIN);
+    bool clockIn = GPIO_ReadPinInput(PS2_CLOCK_GPIO, PS2_CLOCK_PIN);
+
+    uint32_t currentTicks = SysTick->VAL;
+    // SysTick counts down.
+    uint32_t elapsedUs = ((lastEdgeTicks - currentTicks) & SYSTICK_MAX_VALUE) / (SystemCoreClock / 1000000);
+    lastEdgeTicks = currentTicks;
+    edgeAge = 0;
+
+    if (ps2Line.isTransmitting && clockIn) {
+        // Even though we are hooked on InteruptFallingEdge, we are receiving
+        // one spurious wakeup during the initiation sequence
+        return;
     }
 
-    switch (phase) {
-        case 0: {
-            transitionCount++;
-            if (transitionCount == 22) {
-                phase = 1;
-            }
-            break;
-        }
-        case 1: {
-            requestToSend();
-            buffer = 0xff;
-            phase = 2;
+    ps2_drive_t drive;
+    ps2_event_t event = Ps2_HandleFallingEdge(&ps2Line, dataIn, elapsedUs, &drive);
+    driveData(drive);
+
+    switch (event) {
+        case Ps2Event_ByteReceived:
+            processByte(ps2Line.byte);
+            byteAge = 0;
             break;
-        }
-        case 2: {
-            if (writeByte()) {
-                transitionCount = 0;
-                phase = 3;
-            }
+        case Ps2Event_ByteSent:
+            setPhase(TrackpointPhase_WaitForAck);
             break;
-        }
-        case 3: {
-            if (readByte()) {
-                phase = 4;
+        case Ps2Event_Error:
+            // Drop the packet which the corrupted byte belongs to.
+            packetIdx = 0;
+            if (phase == TrackpointPhase_Transmitting) {
+                recover();
             }
             break;
-        }
-        case 4: {
-            requestToSend();
-            buffer = 0xf4;
-            phase = 5;
-            break;
-        }
-        case 5: {
-            if (writeByte()) {
-                phase = 6;
-            }
+        case Ps2Event_None:
             break;
-        }
-        case 6: {
-            if (readByte()) { // read ACK
-                phase = 7;
-                if ( buffer != 0xfa ) {
-                    reportError(1);
-                }
+    }
+}
+
+void Module_Loop(void)
+{
+    while (packetFifoTail != packetFifoHead) {
+        int16_t deltaX, deltaY;
+        Ps2_DecodeMovementPacket(packetFifo[packetFifoTail].data, &deltaX, &deltaY);
+        uint16_t sampleTime = packetFifo[packetFifoTail].sampleTime;
+        packetFifoTail = (packetFifoTail + 1) % PACKET_FIFO_SIZE;
+
+        PointerSeqlock_Add(&PointerDelta, -deltaX, -deltaY, sampleTime);
+    }
+}
+
+// Called every millisecond. Drives timeouts and the non-blocking parts of the host to device
+// communication.
+void Module_OnScan(void)
+{
+    if (phaseTime < UINT16_MAX) {
+        phaseTime++;
+    }
+
+    // An incomplete frame whose clock stopped is dropped.
+    if (edgeAge < UINT8_MAX && ++edgeAge > FRAME_TIMEOUT && ps2Line.bitId > 0 && !ps2Line.isTransmitting) {
+        Ps2_Init(&ps2Line);
+        packetIdx = 0;
+    }
+
+    if (byteAge < UINT8_MAX && ++byteAge > PACKET_TIMEOUT) {
+        packetIdx = 0;
+    }
+
+    if (shouldReset) {
+        shouldReset = false;
+        resetBoard();
+    }
+
+    switch (phase) {
+        case TrackpointPhase_Reset:
+            // finish reset sequence
+            if (phaseTime >= TP_RESET_TIME) {
+                Ps2_Init(&ps2Line);
+                setClockInterrupt(true);
+                GPIO_WritePinOutput(TP_RST_GPIO, TP_RST_PIN, 1);
+                setPhase(TrackpointPhase_WaitForSelfTest);
             }
             break;
-        }
-        case 7: {
-            if (readByte()) {
-                if ((buffer & 0xc8) == 0x08) {
-                    byte1 = buffer;
-                    phase = 8;
+        case TrackpointPhase_WaitForSelfTest:
+        case TrackpointPhase_WaitForDeviceId:
+            if (phaseTime > SELF_TEST_TIMEOUT) {
+                // The trackpoint may have been running already, ask it for a self test.
+                if (retryCount++ < COMMAND_RETRY_COUNT) {
+                    sendByte(PS2_COMMAND_RESET);
                 } else {
-                    // If message format does not match the expected, assume
-                    // the worst - falling out of sync with clock - and reset.
-                    // In case of other errors, just ignore the corrupted frame
-                    // and report the errno.
-                    reportError(2);
-                    phase = 1;
+                    resetBoard();
                 }
             }
             break;
-        }
-        case 8: {
-            if (readByte()) {
-                deltaX = buffer;
-                phase = 9;
+        case TrackpointPhase_RequestToSend:
+            if (--phaseTicks == 0) {
+                finishRequestToSend();
             }
             break;
-        }
-        case 9: {
-            if (readByte()) {
-                deltaY = buffer;
-                if (byte1 & (1 << 4)) {
-                    deltaX |= 0xff00;
-                }
-                if (byte1 & (1 << 5)) {
-                    deltaY |= 0xff00;
-                }
-                if ( errno == 0 ) {
-                    PointerDelta.x -= deltaX;
-                    PointerDelta.y -= deltaY;
-                    lastX = deltaX;
-                    lastY = deltaY;
-                } else {
-                    PointerDelta.x -= lastX;
-                    PointerDelta.y -= lastY;
-                }
-                errno = 0;
-                if (shouldReset) {
-                    shouldReset = false;
-                    resetBoard();
-                    phase = 1;
-
-                } else {
-                    phase = 7;
-                }
+        case TrackpointPhase_Transmitting:
+        case TrackpointPhase_WaitForAck:
+            if (phaseTime > ACK_TIMEOUT) {
+                Ps2_Init(&ps2Line);
+                driveData(Ps2Drive_Release);
+                recover();
             }
             break;
-        }
-    }
-}
-
-void Module_Loop(void)
-{
-}
-
-void Module_OnScan(void)
-{
-    // finish reset sequence
-    if (resetTimer > 0 && --resetTimer == 0) {
-        GPIO_WritePinOutput(TP_RST_GPIO, TP_RST_PIN, 1);
+        case TrackpointPhase_Streaming:
+            break;
     }
 }
 
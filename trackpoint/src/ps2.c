@@ -0,0 +1,140 @@
+#include "ps2.h"
+
+// Bit level PS/2 state machine. It is fed by falling edges of the clock line together with
+// the sampled data line and the time elapsed since the previous edge, and has no hardware
+// dependencies, so that it can be driven by recorded edge traces.
+
+void Ps2_Init(ps2_line_t *line)
+{
+    line->isTransmitting = false;
+    line->bitId = 0;
+    line->byte = 0;
+    line->parity = true;
+    line->frameError = Ps2Error_None;
+}
+
+// The start bit is driven by the caller as part of the request-to-send sequence.
+void Ps2_StartTransmit(ps2_line_t *line, uint8_t byte)
+{
+    line->isTransmitting = true;
+    line->bitId = 0;
+    line->byte = byte;
+    line->parity = true;
+    line->frameError = Ps2Error_None;
+}
+
+static ps2_event_t fail(ps2_line_t *line, ps2_error_t error)
+{
+    line->lastError = error;
+    line->isTransmitting = false;
+    line->bitId = 0;
+    return Ps2Event_Error;
+}
+
+// Device to host frame: start bit (0), 8 data bits LSB first, odd parity, stop bit (1).
+static ps2_event_t receiveBit(ps2_line_t *line, bool dataIn)
+{
+    switch (line->bitId) {
+        case 0: {
+            if (dataIn) {
+                return fail(line, Ps2Error_StartBit);
+            }
+            line->byte = 0;
+            line->parity = true;
+            line->frameError = Ps2Error_None;
+            break;
+        }
+        case 1 ... 8: {
+            line->parity ^= dataIn;
+            line->byte |= dataIn << (line->bitId - 1);
+            break;
+        }
+        case 9: {
+            if (line->parity != dataIn) {
+                line->frameError = Ps2Error_Parity;
+            }
+            break;
+        }
+        case 10: {
+            line->bitId = 0;
+            if (!dataIn) {
+                return fail(line, Ps2Error_StopBit);
+            }
+            if (line->frameError != Ps2Error_None) {
+                return fail(line, line->frameError);
+            }
+            return Ps2Event_ByteReceived;
+        }
+    }
+
+    line->bitId++;
+    return Ps2Event_None;
+}
+
+// Host to device frame: the device clocks, the host changes data while clock is low.
+static ps2_event_t transmitBit(ps2_line_t *line, ps2_drive_t *dataOut)
+{
+    switch (line->bitId) {
+        case 0 ... 7: {
+            bool dataBit = line->byte & (1 << line->bitId);
+            line->parity ^= dataBit;
+            *dataOut = dataBit ? Ps2Drive_High : Ps2Drive_Low;
+            break;
+        }
+        case 8: {
+            *dataOut = line->parity ? Ps2Drive_High : Ps2Drive_Low;
+            break;
+        }
+        case 9: {
+            *dataOut = Ps2Drive_High; // stop bit
+            break;
+        }
+        case 10: {
+            // The device acknowledges the frame by pulling data low during this clock. Its
+            // acknowledge byte is what confirms the command, so just release the line.
+            *dataOut = Ps2Drive_Release;
+            line->isTransmitting = false;
+            line->bitId = 0;
+            return line->frameError == Ps2Error_None ? Ps2Event_ByteSent : fail(line, line->frameError);
+        }
+    }
+
+    line->bitId++;
+    return Ps2Event_None;
+}
+
+ps2_event_t Ps2_HandleFallingEdge(ps2_line_t *line, bool dataIn, uint32_t elapsedUs, ps2_drive_t *dataOut)
+{
+    *dataOut = Ps2Drive_None;
+
+    if (line->bitId > 0 && elapsedUs > PS2_MAX_CLOCK_PERIOD_US) {
+        // The frame got interrupted (e.g., by inhibition or a lost edge). Drop it and
+        // resynchronize by treating this edge as a start bit of a new frame.
+        if (line->isTransmitting) {
+            *dataOut = Ps2Drive_Release;
+        }
+        fail(line, Ps2Error_Timing);
+        receiveBit(line, dataIn);
+        return Ps2Event_Error;
+    }
+
+    if (line->bitId > 0 && elapsedUs < PS2_MIN_CLOCK_PERIOD_US) {
+        // Most likely a glitch on the clock line, the frame is corrupted.
+        line->frameError = Ps2Error_Timing;
+    }
+
+    return line->isTransmitting ? transmitBit(line, dataOut) : receiveBit(line, dataIn);
+}
+
+bool Ps2_IsPacketStart(uint8_t byte)
+{
+    return (byte & PS2_PACKET_SYNC_MASK) == PS2_PACKET_SYNC;
+}
+
+// Decodes the 9-bit two's complement movement deltas of a standard 3-byte movement packet.
+void Ps2_DecodeMovementPacket(const uint8_t *packet, int16_t *x, int16_t *y)
+{
+    uint8_t status = packet[0];
+    *x = packet[1] | (status & PS2_PACKET_X_SIGN ? 0xff00 : 0);
+    *y = packet[2] | (status & PS2_PACKET_Y_SIGN ? 0xff00 : 0);
+}
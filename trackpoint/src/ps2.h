@@ -0,0 +1,75 @@
+#ifndef __PS2_H__
+#define __PS2_H__
+
+// Includes:
+
+    #include <stdint.h>
+    #include <stdbool.h>
+
+// Macros:
+
+    // PS/2 clock runs at 10-16.7 kHz, i.e., one falling edge every 60-100 us.
+    #define PS2_MIN_CLOCK_PERIOD_US 40
+    #define PS2_MAX_CLOCK_PERIOD_US 150
+
+    #define PS2_FRAME_BIT_COUNT 11
+
+    #define PS2_PACKET_SIZE 3
+    #define PS2_PACKET_SYNC_MASK 0xc8 // overflow bits and the always-one bit of the status byte
+    #define PS2_PACKET_SYNC 0x08
+    #define PS2_PACKET_X_SIGN (1 << 4)
+    #define PS2_PACKET_Y_SIGN (1 << 5)
+
+    #define PS2_RESPONSE_ACK 0xfa
+    #define PS2_RESPONSE_RESEND 0xfe
+    #define PS2_RESPONSE_ERROR 0xfc
+    #define PS2_RESPONSE_SELF_TEST_PASSED 0xaa
+
+    #define PS2_COMMAND_RESET 0xff
+    #define PS2_COMMAND_SET_SAMPLE_RATE 0xf3
+    #define PS2_COMMAND_ENABLE_REPORTING 0xf4
+
+    #define PS2_MAX_SAMPLE_RATE 200
+
+// Typedefs:
+
+    typedef enum {
+        Ps2Event_None,
+        Ps2Event_ByteReceived,
+        Ps2Event_ByteSent,
+        Ps2Event_Error,
+    } ps2_event_t;
+
+    typedef enum {
+        Ps2Error_None,
+        Ps2Error_StartBit,
+        Ps2Error_Parity,
+        Ps2Error_StopBit,
+        Ps2Error_Timing,
+    } ps2_error_t;
+
+    typedef enum {
+        Ps2Drive_None,
+        Ps2Drive_Low,
+        Ps2Drive_High,
+        Ps2Drive_Release,
+    } ps2_drive_t;
+
+    typedef struct {
+        bool isTransmitting;
+        uint8_t bitId;
+        uint8_t byte;
+        bool parity;
+        ps2_error_t frameError;
+        ps2_error_t lastError;
+    } ps2_line_t;
+
+// Functions:
+
+    void Ps2_Init(ps2_line_t *line);
+    void Ps2_StartTransmit(ps2_line_t *line, uint8_t byte);
+    ps2_event_t Ps2_HandleFallingEdge(ps2_line_t *line, bool dataIn, uint32_t elapsedUs, ps2_drive_t *dataOut);
+    bool Ps2_IsPacketStart(uint8_t byte);
+    void Ps2_DecodeMovementPacket(const uint8_t *packet, int16_t *x, int16_t *y);
+
+#endif